@@ -1,5 +1,7 @@
 #version 330
 
+// Edges drawn as GL_LINES from an index buffer that holds each edge once.
+
 #ifdef VERTEX_SHADER
 layout(location= 0) in vec3 aPosition;
 
@@ -11,24 +13,6 @@ void main()
 }
 #endif
 
-#ifdef GEOMETRY_SHADER
-layout(triangles) in; 
-layout(line_strip, max_vertices= 4) out; 
-
-void main()
-{
-    gl_Position= gl_in[0].gl_Position; 
-    EmitVertex();
-    gl_Position= gl_in[1].gl_Position; 
-    EmitVertex();
-    gl_Position= gl_in[2].gl_Position; 
-    EmitVertex();
-    gl_Position= gl_in[0].gl_Position; 
-    EmitVertex();
-}
-#endif
-
-
 #ifdef FRAGMENT_SHADER
 out vec4 out_color; 
 
@@ -34,6 +34,8 @@ protected:
     virtual int postrender();
 
     void center_camera(const Mesh& mesh);
+    //! Center the camera on the bounding box <min, max>.
+    void center_camera(const std::pair<Point, Point>& bounds);
 
     std::pair<int, int> cpu_time() const { return {m_cpu_time / 1000, m_cpu_time % 1000}; }
     std::pair<int, int> gpu_time() const { return {int(m_frame_time / 1e6), int((m_frame_time / 1000) % 1000)}; }
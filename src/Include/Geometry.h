@@ -20,6 +20,33 @@ namespace gam
         friend std::ostream &operator<<(std::ostream &out, const Vertex &v);
     };
 
+    //! Vertices stored as a structure of arrays : geometry-only loops only read the coordinates they need.
+    struct VertexArray
+    {
+        std::vector<ScalarType> X, Y, Z;
+        std::vector<int> FaceIndex;
+
+        //! Get the number of vertices.
+        inline IndexType size() const { return X.size(); }
+
+        void reserve(IndexType count);
+        void resize(IndexType count);
+        void clear();
+
+        void emplace_back(const Point &point, int i_face = -1);
+        void emplace_back(ScalarType x, ScalarType y, ScalarType z, int i_face = -1);
+
+        //! Set the position of the vertex of index i, its face is kept.
+        void position(IndexType i, const Point &point);
+
+        //! Get the position of the vertex of index i.
+        inline Point point(IndexType i) const { return Point(X[i], Y[i], Z[i]); }
+        inline Vector vector(IndexType i) const { return Vector(X[i], Y[i], Z[i]); }
+
+        //! Get a copy of the vertex of index i.
+        inline Vertex operator[](IndexType i) const { return Vertex(X[i], Y[i], Z[i], FaceIndex[i]); }
+    };
+
     struct Face
     {
         Face() = default;
@@ -51,7 +78,7 @@ namespace gam
 
     ScalarType cotan(const Vector &u, const Vector &v);
 
-    //! Orientation predicate : returns a positive value if the three given points are oriented counter-clockwise, negative if they are oriented clockwise or zero if they are aligned.
+    //! Orientation predicate : returns a positive value if the three given points are oriented counter-clockwise, negative if they are oriented clockwise or zero if they are aligned. The result is exact (see Predicates.h).
     int orientation(const Point &a, const Point &b, const Point &c);
 
     //! In triangle predicate : returns a positive value if p is located inside the triangle defined by the vertices (a, b, c), negative if it is located outside or zero if it is located on the boundary.
@@ -63,9 +90,15 @@ namespace gam
     //! Returns the index of the edge of the CDE triangle intersected by the segment AB, -1 if no intersection exists.  
     int intersected_edge(const Point& a, const Point& b, const Point& c, const Point& d, const Point& e);
 
-    //! Returns true if a point p is in a circle circumscribed at a, b and c, false otherwise.
+    //! Returns true if a point p is in (or on) the circle circumscribed at a, b and c, false otherwise. The result is exact (see Predicates.h).
     bool in_circle(const Point& p, const Point& a, const Point& b, const Point& c);
 
+    //! Returns 1 if p is strictly inside the circle circumscribed at a, b and c (oriented counter-clockwise), -1 if it is strictly outside, 0 if it is on the circle.
+    int circle_side(const Point& p, const Point& a, const Point& b, const Point& c);
+
+    //! Compute the center (cx, cy) and the radius r of the circle circumscribed at a, b and c in the xy plane. Returns false if the points are aligned.
+    bool circumcircle(const Point& a, const Point& b, const Point& c, double& cx, double& cy, double& r);
+
     ScalarType det(ScalarType i, ScalarType j, ScalarType k, ScalarType l);
 
 } // namespace gam
\ No newline at end of file
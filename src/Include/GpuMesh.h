@@ -0,0 +1,83 @@
+#pragma once
+
+#include "TMesh.h"
+
+//! Copy of a TMesh in GPU buffers, one buffer per vertex attribute (position, scalar channel, normal) plus the triangle and edge index buffers. Each buffer keeps a copy of what it holds : an update only sends the ranges that changed, and new vertices and faces are appended.
+class GpuMesh
+{
+public:
+    GpuMesh() = default;
+
+    GpuMesh(const GpuMesh &) = delete;
+    GpuMesh &operator=(const GpuMesh &) = delete;
+
+    //! Synchronize the buffers with the mesh. The scalar channel is the curvature if `curvature` is true, the vertex values otherwise. With remove_infinite, the infinite faces become degenerate triangles : every face keeps its slot in the index buffer.
+    void update(const gam::TMesh &mesh, bool curvature = true, bool remove_infinite = false);
+
+    //! Synchronize only the scalar channel, rewritten as a whole in an orphaned buffer (the other attributes must be up to date).
+    void update_values(const gam::TMesh &mesh, bool curvature);
+
+    //! Draw the faces with the current program.
+    void draw_triangles() const;
+
+    //! Draw each edge once as a line, with the current program.
+    void draw_edges() const;
+
+    //! Draw the vertices with the current program.
+    void draw_points() const;
+
+    inline int vertex_count() const { return m_vertex_count; }
+
+    //! Get the number of drawn (non-degenerate) triangles.
+    inline int triangle_count() const { return m_triangle_count; }
+
+    //! Get the number of drawn edges.
+    inline int edge_count() const { return m_edge_count; }
+
+    //! Get the bounding box of the vertices : <min, max>.
+    inline std::pair<Point, Point> bounds() const { return {m_pmin, m_pmax}; }
+
+    //! Get the number of bytes sent by the last update.
+    inline std::size_t uploaded_bytes() const { return m_uploaded_bytes; }
+
+    void release();
+
+private:
+    struct Buffer
+    {
+        GLuint Id{0};
+        std::size_t Capacity{0};
+        //! Content of the buffer, as last sent.
+        std::vector<char> Shadow;
+    };
+
+    void create();
+
+    //! Send the elements of data that differ from the shadow of the buffer, growing the buffer if needed. Returns the number of bytes sent.
+    std::size_t upload(Buffer &buffer, GLenum target, const void *data, std::size_t count, std::size_t element_size);
+
+    //! Enable the attribute at location if it has data, its value is `fallback` otherwise.
+    void attribute(GLuint location, bool enabled, float fallback_x, float fallback_y, float fallback_z);
+
+private:
+    GLuint m_vao{0};
+    //! Positions and edge indices : the index buffer is part of the vertex array state.
+    GLuint m_edge_vao{0};
+    Buffer m_positions;
+    Buffer m_values;
+    Buffer m_normals;
+    Buffer m_indices;
+    Buffer m_edges;
+
+    //! Positions and triangle indices exported by the mesh, kept to avoid reallocations.
+    std::vector<vec3> m_position_staging;
+    std::vector<std::uint32_t> m_index_staging;
+    std::vector<std::uint32_t> m_edge_staging;
+
+    int m_vertex_count{0};
+    int m_triangle_count{0};
+    int m_index_count{0};
+    int m_edge_count{0};
+    Point m_pmin, m_pmax;
+    std::size_t m_uploaded_bytes{0};
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Events of the hot paths of TMesh, counted when GAM_INSTRUMENTATION is defined.
+    enum class Counter
+    {
+        //! Calls to locate_triangle.
+        Locates,
+        //! Faces crossed by the point location walks.
+        WalkSteps,
+        LawsonCalls,
+        //! Flips done by lawson (included in Flips).
+        LawsonFlips,
+        //! Every call to flip_edge.
+        Flips,
+        //! Calls to triangle_split, insert_outside included.
+        TriangleSplits,
+        EdgeSplits,
+        InsertOutside,
+        //! Faces gathered around the infinite vertex and hull edges tested by insert_outside.
+        HullWalkSteps,
+        //! Insertions by the Bowyer-Watson engine.
+        Cavities,
+        //! Faces removed by the Bowyer-Watson insertions.
+        CavityFaces,
+        //! Calls to remove_vertex that removed a vertex.
+        VertexRemovals,
+        //! Faces created by the removals.
+        RemovalFaces,
+        //! Vertices moved by move_vertex and move_vertices.
+        VertexMoves,
+        //! Moves done by a removal and an insertion (included in VertexMoves and VertexRemovals).
+        MoveReinsertions,
+        Count
+    };
+
+    constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::Count);
+
+    //! Values of the counters, summed over all the threads since the start of the program (or the last reset).
+    struct InstrumentationStats
+    {
+        std::array<std::uint64_t, COUNTER_COUNT> Values{};
+
+        inline std::uint64_t operator[](Counter counter) const { return Values[static_cast<std::size_t>(counter)]; }
+    };
+
+    //! Get the name of a counter, as written in the reports.
+    const char *counter_name(Counter counter);
+
+    //! Get the counters, all zero if the instrumentation is disabled.
+    InstrumentationStats instrumentation_stats();
+
+    //! Reset the counters and drop the recorded scopes.
+    void reset_instrumentation_stats();
+
+    //! Write the scopes recorded by GAM_TRACE_SCOPE as a Chrome trace (chrome://tracing or ui.perfetto.dev), with the counters as metadata. Returns false if the file can not be written or if the instrumentation is disabled.
+    bool write_chrome_trace(const std::string &filename);
+
+#ifdef GAM_INSTRUMENTATION
+    namespace instrumentation
+    {
+        //! Counters of the calling thread : only this thread writes them, the relaxed atomics let the readers sum them without a lock.
+        std::atomic<std::uint64_t> *thread_counters();
+
+        inline void add(Counter counter, std::uint64_t value)
+        {
+            std::atomic<std::uint64_t> &total = thread_counters()[static_cast<std::size_t>(counter)];
+            total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        //! Records the duration of the enclosing scope in the trace of the calling thread.
+        class Scope
+        {
+        public:
+            explicit Scope(const char *name) : m_name(name), m_start(std::chrono::steady_clock::now()) {}
+            ~Scope();
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            const char *m_name;
+            std::chrono::steady_clock::time_point m_start;
+        };
+    } // namespace instrumentation
+#endif
+} // namespace gam
+
+#ifdef GAM_INSTRUMENTATION
+#define GAM_CONCAT_IMPL(a, b) a##b
+#define GAM_CONCAT(a, b) GAM_CONCAT_IMPL(a, b)
+//! Add value to a gam::Counter.
+#define GAM_COUNT(counter, value) ::gam::instrumentation::add(::gam::Counter::counter, value)
+//! Record the duration of the enclosing scope under name (a string literal).
+#define GAM_TRACE_SCOPE(name) ::gam::instrumentation::Scope GAM_CONCAT(gam_trace_scope_, __LINE__)(name)
+#else
+#define GAM_COUNT(counter, value) ((void)0)
+#define GAM_TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "TMesh.h"
+
+namespace gam
+{
+    //! Task run on its own thread, which reports its progress and can be cancelled. Its result is taken by the thread which started it, once the task is finished.
+    template <typename Result>
+    class Job
+    {
+    public:
+        //! The task returns no result if it failed or was cancelled.
+        using Task = std::function<std::optional<Result>(const ProgressCallback &)>;
+
+        Job() = default;
+        ~Job()
+        {
+            cancel();
+            wait();
+        }
+
+        Job(const Job &) = delete;
+        Job &operator=(const Job &) = delete;
+
+        //! Start task on a worker thread, the running task is cancelled first.
+        void start(Task task)
+        {
+            cancel();
+            wait();
+
+            m_result.reset();
+            m_progress = 0.f;
+            m_cancelled = false;
+            m_finished = false;
+            m_thread = std::thread([this, task = std::move(task)]()
+                                   {
+                m_result = task([this](float progress)
+                                {
+                    m_progress = progress;
+                    return !m_cancelled; });
+                m_finished = true; });
+        }
+
+        //! Ask the task to stop, at its next progress report.
+        inline void cancel() { m_cancelled = true; }
+
+        //! Returns true from `start` until the result is taken.
+        inline bool running() const { return m_thread.joinable(); }
+
+        inline bool cancelled() const { return m_cancelled; }
+
+        //! Get the last progress reported by the task, in [0, 1].
+        inline float progress() const { return m_progress; }
+
+        //! Once the task is finished, join its thread and returns its result. Returns nothing while the task runs, or if it failed or was cancelled.
+        std::optional<Result> take()
+        {
+            if (!m_thread.joinable() || !m_finished)
+                return std::nullopt;
+
+            m_thread.join();
+            std::optional<Result> result = std::move(m_result);
+            m_result.reset();
+            return result;
+        }
+
+    private:
+        void wait()
+        {
+            if (m_thread.joinable())
+                m_thread.join();
+        }
+
+    private:
+        std::thread m_thread;
+        std::optional<Result> m_result;
+        std::atomic<float> m_progress{0.f};
+        std::atomic<bool> m_cancelled{false};
+        //! Set after m_result is written : reading m_result is safe once it is true.
+        std::atomic<bool> m_finished{false};
+    };
+} // namespace gam
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Read-only view of the content of a whole file. The file is memory-mapped on POSIX systems, read into memory otherwise.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string &filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        //! Returns true if the file could be opened.
+        inline bool is_open() const { return m_open; }
+
+        inline const char *data() const { return m_data; }
+        inline std::size_t size() const { return m_size; }
+
+        inline const char *begin() const { return m_data; }
+        inline const char *end() const { return m_data + m_size; }
+
+    private:
+        const char *m_data{nullptr};
+        std::size_t m_size{0};
+        bool m_open{false};
+        bool m_mapped{false};
+
+        //! Content of the file when it can not be mapped.
+        std::vector<char> m_buffer;
+    };
+
+    //! Sequential reader of whitespace separated numbers, '#' starts a comment until the end of the line.
+    class TextReader
+    {
+    public:
+        TextReader(const char *begin, const char *end) : m_begin(begin), m_current(begin), m_end(end) {}
+
+        //! Read the next word and returns true if it is equal to `keyword`.
+        bool keyword(std::string_view keyword);
+
+        //! Read the next number, returns false if there is none.
+        template <typename T>
+        bool read(T &value)
+        {
+            skip_blanks();
+            auto [next, error] = std::from_chars(m_current, m_end, value);
+            if (error != std::errc())
+                return false;
+            m_current = next;
+            return true;
+        }
+
+        //! Returns true if only blanks and comments are left.
+        bool at_end();
+
+        //! Get the position of the next character to read.
+        inline const char *position() const { return m_current; }
+
+        //! Get the current line number (for error messages).
+        IndexType line() const;
+
+    private:
+        void skip_blanks();
+
+    private:
+        const char *m_begin;
+        const char *m_current;
+        const char *m_end;
+    };
+} // namespace gam
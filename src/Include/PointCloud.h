@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Read the points of a cloud, the format is chosen from the extension of the file :
+    //! .txt : point count, then "x y z" per line ;
+    //! .xyzf / .xyzd : x y z of each point as little-endian float32 / float64, without header ;
+    //! .ply : properties x y z (z optional) of the vertex element, binary little-endian or ascii.
+    //! The file is memory-mapped and the text is parsed by chunks on the shared thread pool. Returns nothing, with an error message, if the file can not be read.
+    std::optional<std::vector<Point>> read_points(const std::string &filename);
+
+    //! Returns true if read_points accepts the extension of the file.
+    bool is_point_cloud(const std::filesystem::path &file);
+} // namespace gam
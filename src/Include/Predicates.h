@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Number of predicate evaluations that could not be decided by the floating-point filter and took the exact path.
+    struct PredicateStats
+    {
+        std::uint64_t OrientationExact{0};
+        std::uint64_t InCircleExact{0};
+    };
+
+    /*
+     * Adaptive predicates in the spirit of J. R. Shewchuk. The determinant is first evaluated in double precision together
+     * with a bound on its rounding error. If the sign cannot be trusted, it is evaluated again exactly (see Predicates.cpp).
+     */
+
+    //! Half of the machine epsilon of a double.
+    constexpr double PREDICATES_EPSILON = 0x1p-53;
+
+    //! Relative error bounds of the floating-point filters.
+    constexpr double CCW_ERRBOUND = (3.0 + 16.0 * PREDICATES_EPSILON) * PREDICATES_EPSILON;
+    constexpr double ICC_ERRBOUND = (10.0 + 96.0 * PREDICATES_EPSILON) * PREDICATES_EPSILON;
+
+    //! Exact orientation determinant, used when the filter of orient2d fails.
+    double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy);
+
+    //! Exact in-circle determinant, used when the filter of incircle fails.
+    double incircle_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+    //! Returns a positive value if a, b and c are oriented counter-clockwise, a negative value if they are oriented clockwise and zero if they are aligned. The sign is exact.
+    inline double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+    {
+        double detleft = (ax - cx) * (by - cy);
+        double detright = (ay - cy) * (bx - cx);
+        double det = detleft - detright;
+
+        double detsum;
+        if (detleft > 0.)
+        {
+            if (detright <= 0.)
+                return det;
+            detsum = detleft + detright;
+        }
+        else if (detleft < 0.)
+        {
+            if (detright >= 0.)
+                return det;
+            detsum = -detleft - detright;
+        }
+        else
+        {
+            return det;
+        }
+
+        double errbound = CCW_ERRBOUND * detsum;
+        if (det >= errbound || -det >= errbound)
+            return det;
+
+        return orient2d_exact(ax, ay, bx, by, cx, cy);
+    }
+
+    //! Returns a positive value if d lies inside the circle passing through a, b and c (oriented counter-clockwise), a negative value if it lies outside and zero if the four points are cocircular. The sign is exact.
+    inline double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+    {
+        double adx = ax - dx, ady = ay - dy;
+        double bdx = bx - dx, bdy = by - dy;
+        double cdx = cx - dx, cdy = cy - dy;
+
+        double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+        double cdxady = cdx * ady, adxcdy = adx * cdy;
+        double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+        double alift = adx * adx + ady * ady;
+        double blift = bdx * bdx + bdy * bdy;
+        double clift = cdx * cdx + cdy * cdy;
+
+        double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+        double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                           (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                           (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+        double errbound = ICC_ERRBOUND * permanent;
+        if (det > errbound || -det > errbound)
+            return det;
+
+        return incircle_exact(ax, ay, bx, by, cx, cy, dx, dy);
+    }
+
+    //! Get the number of exact evaluations since the start of the program (or the last reset).
+    PredicateStats predicate_stats();
+
+    //! Reset the exact evaluations counters.
+    void reset_predicate_stats();
+} // namespace gam
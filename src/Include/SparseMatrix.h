@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+namespace gam
+{
+    //! Sparse matrix stored in Compressed Sparse Row format : the entries of the row i are at the positions [RowStart[i], RowStart[i + 1]) of Columns and Values.
+    struct SparseMatrix
+    {
+        std::vector<IndexType> RowStart;
+        std::vector<IndexType> Columns;
+        //! Stored in double : the rows of a Laplacian sum to zero and their products cancel each other.
+        std::vector<double> Values;
+
+        //! Get the number of rows of the matrix.
+        inline IndexType rows() const { return RowStart.empty() ? 0 : RowStart.size() - 1; }
+
+        //! Get the number of stored entries.
+        inline IndexType non_zeros() const { return Columns.size(); }
+
+        //! Get the position in Values of the entry (i, j), -1 if it is not stored.
+        int find(IndexType i, IndexType j) const;
+
+        //! Get the i-th entry of the product A x.
+        template <typename T>
+        T row_product(IndexType i, const std::vector<T> &x) const
+        {
+            assert(i < rows());
+
+            double sum = 0.;
+            for (IndexType k = RowStart[i]; k < RowStart[i + 1]; ++k)
+            {
+                sum += Values[k] * x[Columns[k]];
+            }
+            return sum;
+        }
+
+        //! Compute the product y = A x, the rows are distributed on the thread pool.
+        template <typename T>
+        void multiply(const std::vector<T> &x, std::vector<T> &y) const
+        {
+            assert(x.size() == rows());
+
+            y.resize(rows());
+            parallel_for(rows(), [&](IndexType begin, IndexType end)
+                         {
+                for (IndexType i = begin; i < end; ++i)
+                {
+                    y[i] = row_product(i, x);
+                } });
+        }
+
+        //! Get the diagonal entries (0 if they are not stored).
+        std::vector<double> diagonal() const;
+
+        void clear();
+    };
+
+    //! Convergence of an iterative solver.
+    struct SolverStats
+    {
+        IndexType Iterations{0};
+
+        //! Relative residual ||b - A x|| / ||b||.
+        double Residual{0.};
+
+        bool Converged{false};
+    };
+
+    //! Solve A x = b with the conjugate gradient method preconditioned by the diagonal of A (Jacobi), A must be symmetric positive definite. x holds the initial guess.
+    SolverStats conjugate_gradient(const SparseMatrix &A, const std::vector<double> &b, std::vector<double> &x, IndexType max_iterations = 1000, double tolerance = 1e-6);
+} // namespace gam
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Returns the position of the cell (x, y) along the Hilbert curve filling a grid of 2^order x 2^order cells.
+    std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y, int order);
+
+    //! Square grid quantizing the coordinates for the Hilbert curve, fitted to a bounding box : a coordinate maps to the cell (x - XMin) * Scale.
+    struct HilbertGrid
+    {
+        ScalarType XMin, YMin;
+        double Scale;
+    };
+
+    //! Get the grid fitted to the bounding box of the points.
+    HilbertGrid hilbert_grid(std::span<const Point> points);
+
+    //! Sort the indices in [begin, end) along a Hilbert curve, using the x and y coordinates of the corresponding points. The curve is fitted to the bounding box of all the points.
+    void hilbert_sort(std::span<const Point> points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end);
+
+    //! Same as above, on a grid already computed (the points of [begin, end) must be inside its box).
+    void hilbert_sort(std::span<const Point> points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end, const HilbertGrid &grid);
+
+    //! Biased Randomized Insertion Order : returns the indices of the `point_count` first points, shuffled then split in rounds of doubling size, each round being sorted along a Hilbert curve.
+    std::vector<IndexType> brio_order(const std::vector<Point> &points, IndexType point_count, unsigned seed = std::random_device{}());
+} // namespace gam
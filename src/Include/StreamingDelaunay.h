@@ -0,0 +1,32 @@
+#pragma once
+
+#include "TMesh.h"
+
+namespace gam
+{
+    struct StreamingOptions
+    {
+        //! Number of points read at a time : the memory used is bounded by a chunk and the front of the triangulation.
+        IndexType ChunkSize{1 << 20};
+
+        //! Directory of the temporary files (the system temporary directory if empty).
+        std::filesystem::path TemporaryDirectory;
+
+        //! Algorithm inserting the points of each strip.
+        InsertionEngine Engine{InsertionEngine::Lawson};
+    };
+
+    struct StreamingStats
+    {
+        std::uint64_t PointCount{0};
+        //! Points at the position of a previous point, they are written but not triangulated.
+        std::uint64_t DuplicateCount{0};
+        std::uint64_t TriangleCount{0};
+        IndexType ChunkCount{0};
+        //! Largest number of points triangulated at a time (chunk and front).
+        IndexType MaxActivePoints{0};
+    };
+
+    //! Out-of-core Delaunay triangulation of a point cloud (.txt) into an .obj or .off file, for clouds larger than the memory. The points are bucketed into vertical strips of about `ChunkSize` points (temporary files), the strips are triangulated from left to right and the triangles whose circumcircle lies left of the next strips are written as soon as they are known. Returns nothing if a file can not be read or written, or if `progress` cancels the triangulation.
+    std::optional<StreamingStats> triangulate_streaming(const std::string &cloud_file, const std::string &output_file, const StreamingOptions &options = {}, const ProgressCallback &progress = nullptr);
+} // namespace gam
@@ -1,9 +1,40 @@
 #pragma once
 
 #include "Geometry.h"
+#include "SparseMatrix.h"
 
 namespace gam
 {
+    //! Version of the .tmesh binary format, files of another version are rejected.
+    constexpr std::uint32_t TMESH_VERSION = 1;
+
+    //! Called by the long operations with their progress in [0, 1] : returning false cancels the operation.
+    using ProgressCallback = std::function<bool(float)>;
+
+    //! Choice of the face from which the point location walk starts.
+    enum class LocateStrategy
+    {
+        FirstFace,    //! Always start from the face 0.
+        LastInserted, //! Start from the face of the last inserted vertex.
+        JumpAndWalk,  //! Start from the nearest of a few randomly sampled vertices.
+        Hierarchy,    //! Descend the Delaunay hierarchy (triangulations of random subsets of the vertices, each about 30 times smaller than the one below) : O(log n) expected walk, whatever the order of the points.
+    };
+
+    //! Algorithm inserting a vertex into the Delaunay triangulation.
+    enum class InsertionEngine
+    {
+        Lawson,       //! Split the face (or edge) containing the point, then flip the edges that are not Delaunay.
+        BowyerWatson, //! Remove the faces whose circumcircle contains the point and connect the point to the border of the hole.
+    };
+
+    //! Location of a point in the triangulation : the face that contains it and its barycentric weights relative to the vertices of the face. A point outside of the mesh gets the infinite face beyond the hull edge that the walk crossed, with the weights of its projection on this edge (0 for the infinite vertex).
+    struct PointLocation
+    {
+        IndexType Face{0};
+        std::array<ScalarType, 3> Weights{};
+        bool Inside{false};
+    };
+
     //! Triangulated mesh.
     class TMesh
     {
@@ -11,10 +42,21 @@ namespace gam
         TMesh() = default;
         TMesh(const std::vector<ScalarType> &values) : m_values(values) {}
 
+#ifndef GAM_HEADLESS
         Mesh mesh(bool curvature = true, bool remove_infinite = false) const;
+#endif
+
+        //! Write the positions of the vertices, interleaved as expected by a vertex buffer. `positions` must hold vertex_count() entries.
+        void export_positions(std::span<vec3> positions) const;
+
+        //! Write the vertex indices of the faces, `indices` must hold 3 face_count() entries. With remove_infinite, the infinite faces are skipped, or written as degenerate triangles (0, 0, 0) if keep_slots is true, so that the face i stays at the position 3 i. Returns the number of triangles that are not removed.
+        IndexType export_triangles(std::span<std::uint32_t> indices, bool remove_infinite, bool keep_slots = false) const;
+
+        //! Write each edge once, as a pair of vertex indices : the face i writes the edges it shares with a face of greater index, a missing face or a removed infinite face. `indices` must hold 6 face_count() entries. With keep_slots, the edges of the face i are at the positions [6 i, 6 i + 6) and the edges written by a neighbor are degenerate (0, 0); they are compacted otherwise. Returns the number of edges written, degenerate ones excluded.
+        IndexType export_edges(std::span<std::uint32_t> indices, bool remove_infinite, bool keep_slots = false) const;
 
         //! Set a vertex position. 
-        void vertex(IndexType i_vertex, const Point& p) { assert(i_vertex < vertex_count()); m_vertices[i_vertex] = p; } 
+        void vertex(IndexType i_vertex, const Point& p) { assert(i_vertex < vertex_count()); m_vertices.position(i_vertex, p); m_operator_dirty = true; } 
 
         //! Set the vertex value at index i.
         void vertex_value(IndexType i_vertex, ScalarType v);
@@ -29,23 +71,51 @@ namespace gam
         ScalarType vertex_value(IndexType i_vertex) const;
 
         //! Get the values of all vertices.
-        inline std::vector<ScalarType> vertices_values() const { return m_values; }
+        inline const std::vector<ScalarType> &vertices_values() const { return m_values; }
+
+        //! Get the curvature of all vertices (empty until `curvature` is called).
+        inline const std::vector<ScalarType> &curvatures() const { return m_curvature; }
+
+        //! Get the normals of all vertices (empty until `smooth_normals` is called).
+        inline const std::vector<Vector> &normals() const { return m_normals; }
+
+        //! Get the vertices of the mesh.
+        inline const VertexArray &vertices() const { return m_vertices; }
 
-        //! Get the number of vertex of the mesh.
+        //! Get the faces of the mesh.
+        inline const std::vector<Face> &faces() const { return m_faces; }
+
+        //! Get the number of vertex of the mesh (free slots included).
         inline IndexType vertex_count() const { return m_vertices.size(); }
 
-        //! Get the number of face of the mesh.
+        //! Get the number of face of the mesh (free slots included).
         inline IndexType face_count() const { return m_faces.size(); }
 
-        //! Load and triangulate a mesh from an OFF file.
-        void load_off(const std::string &off_file);
+        //! Returns true if the vertex of index i_vertex was removed and its slot is not reused yet.
+        inline bool is_free_vertex(IndexType i_vertex) const { return m_vertices.FaceIndex[i_vertex] < 0; }
+
+        //! Returns true if the face of index i_face was removed and its slot is not reused yet (its vertices are -1).
+        inline bool is_free_face(IndexType i_face) const { return m_faces[i_face].Vertices[0] < 0; }
+
+        //! Get the number of free vertex and face slots, they are reused by the insertions and removed by `compact`.
+        inline IndexType free_vertex_count() const { return m_free_vertices.size(); }
+        inline IndexType free_face_count() const { return m_free_faces.size(); }
 
-        //! Save the mesh as a .obj file.
+        //! Load a closed triangulated mesh from an OFF file. Returns false (and leaves the mesh empty) if the file can not be read or if the mesh has a boundary or non-manifold edge.
+        bool load_off(const std::string &off_file);
+
+        //! Save the mesh as a .obj file (the mesh is compacted first).
         void save_obj(const std::string &obj_file, bool use_curvature = false, bool remove_inf = false);
 
-        //! Save the mesh as a .off file.
+        //! Save the mesh as a .off file (the mesh is compacted first).
         void save_off(const std::string &off_file, bool remove_inf = false);
 
+        //! Save the whole mesh (vertices, sewn faces, normals, values and curvature) as a binary .tmesh file in the TMesh data directory.
+        bool save_tmesh(const std::string &tmesh_file) const;
+
+        //! Load a mesh saved by `save_tmesh` : the file is mapped and its arrays are copied as they are, without parsing. Returns false (and leaves the mesh empty) if the file is missing, of another version or corrupted.
+        bool load_tmesh(const std::string &tmesh_file);
+
         //! Get the local index for a vertex located on the face of index `i_face`.
         IndexType local_index(IndexType i_vertex, IndexType i_face) const;
 
@@ -64,6 +134,37 @@ namespace gam
         //! Get the index of the neighboring vertices of a vertex.
         std::vector<IndexType> neighboring_vertices_of_vertex(IndexType i_vertex) const;
 
+        //! Call visit(i_face) on each face around the vertex of index i_vertex, counterclockwise. Unlike `neighboring_faces_of_vertex`, nothing is allocated.
+        template <typename Visit>
+        void for_each_face_of_vertex(IndexType i_vertex, Visit &&visit) const
+        {
+            assert(i_vertex < vertex_count());
+
+            IndexType i_start = m_vertices.FaceIndex[i_vertex];
+            IndexType i_face = i_start;
+            do
+            {
+                visit(i_face);
+                i_face = m_faces[i_face].Neighbors[(ring_index(i_vertex, i_face) + 1) % 3];
+            } while (i_face != i_start);
+        }
+
+        //! Call visit(i_neighbor) on each vertex around the vertex of index i_vertex, counterclockwise. Unlike `neighboring_vertices_of_vertex`, nothing is allocated.
+        template <typename Visit>
+        void for_each_vertex_of_vertex(IndexType i_vertex, Visit &&visit) const
+        {
+            assert(i_vertex < vertex_count());
+
+            IndexType i_start = m_vertices.FaceIndex[i_vertex];
+            IndexType i_face = i_start;
+            do
+            {
+                IndexType i_next = (ring_index(i_vertex, i_face) + 1) % 3;
+                visit(static_cast<IndexType>(m_faces[i_face].Vertices[i_next]));
+                i_face = m_faces[i_face].Neighbors[i_next];
+            } while (i_face != i_start);
+        }
+
         //! Calculate the area of the face of index i_face.
         ScalarType face_area(IndexType i_face) const;
 
@@ -73,6 +174,12 @@ namespace gam
         //! Calculate the Laplacian of a discrete function defined on the mesh.
         void laplacian();
 
+        //! Get the cotangent Laplacian matrix : (L u)_i = 1/2 sum_j (cot alpha_ij + cot beta_ij) (u_j - u_i). It is rebuilt only if the mesh changed since the last call, the free slots are skipped (their rows are empty).
+        const SparseMatrix &laplacian_operator();
+
+        //! Get the lumped mass of each vertex (a third of the area of its incident faces), the Laplacian of u at the vertex i is (L u)_i / mass_i.
+        const std::vector<ScalarType> &lumped_mass();
+
         Vector face_normal(IndexType i_face) const;
 
         //! Compute normal of each vertex of the mesh.
@@ -87,48 +194,161 @@ namespace gam
         //! Calculate the vertex value for the heat diffusion.
         void heat_diffusion(IndexType i_vertex, ScalarType delta_time);
 
+        //! Perform heat diffusion with an implicit (backward Euler) step : solves (M - dt L) u' = M u with a preconditioned conjugate gradient, stable for any time step. The vertex 0 keeps its value.
+        SolverStats heat_diffusion_implicit(ScalarType delta_time);
+
+        //! Get the convergence of the last implicit heat diffusion step.
+        inline const SolverStats &solver_stats() const { return m_solver_stats; }
+
         //! Insert a vertex of position p.
         void insert_vertex(float x, float y, float z);
 
-        //! Insert a vertex of position p.
-        void insert_vertex(const Point &p);
+        //! Insert a vertex of position p, returns its index.
+        IndexType insert_vertex(const Point &p);
+
+        //! Insert a vertex of position p, the point location starts from the face of index i_hint_face. Returns the index of the vertex.
+        IndexType insert_vertex(const Point &p, IndexType i_hint_face);
+
+        //! Set the strategy used to choose the starting face of the point location. The Delaunay hierarchy is built when the strategy becomes Hierarchy, then kept up to date by the insertions, removals and moves; it is dropped by the other strategies.
+        void locate_strategy(LocateStrategy strategy);
+
+        //! Get the strategy used to choose the starting face of the point location.
+        inline LocateStrategy locate_strategy() const { return m_locate_strategy; }
+
+        //! Set the algorithm used to insert the vertices.
+        inline void insertion_engine(InsertionEngine engine) { m_insertion_engine = engine; }
+
+        //! Get the algorithm used to insert the vertices.
+        inline InsertionEngine insertion_engine() const { return m_insertion_engine; }
+
+        //! Get the number of levels of the Delaunay hierarchy above the mesh (0 without hierarchy).
+        IndexType hierarchy_level_count() const;
+
+        //! Get the memory used by the levels of the Delaunay hierarchy, in bytes.
+        std::size_t hierarchy_memory() const;
+
+        //! Locate each query in the triangulation, `locations` must hold queries.size() entries. The queries are sorted along a Hilbert curve and split between the threads of the pool, each walk starts from the face of the previous query. The mesh must not change during the call.
+        void locate_points(std::span<const Point> queries, std::span<PointLocation> locations) const;
+
+        //! Interpolate the vertex values at the locations given by `locate_points`, `values` must hold locations.size() entries.
+        void interpolate_values(std::span<const PointLocation> locations, std::span<ScalarType> values) const;
+
+        //! Get the average number of faces visited by the point location since the last reset.
+        inline float average_walk_length() const { return m_locate_count == 0 ? 0.f : static_cast<float>(static_cast<double>(m_walk_steps) / m_locate_count); }
+
+        //! Reset the point location statistics.
+        inline void reset_walk_stats() { m_walk_steps = m_locate_count = 0; }
+
+        //! Remove the vertex of index i_vertex from the Delaunay triangulation : the hole left by its faces is filled by the Delaunay triangulation of its neighbors, built ear by ear. Its slot and two face slots become free. Returns false, and leaves the mesh unchanged, for the infinite vertex, a free vertex or if the remaining vertices are aligned.
+        bool remove_vertex(IndexType i_vertex);
+
+        //! Remove the free slots left by `remove_vertex` : the vertices and faces are renumbered in the same order.
+        void compact();
+
+        //! Move the vertex of index i_vertex to p, it keeps its index. If the faces around it stay counterclockwise, only its position changes and the Delaunay property is restored by flips around it; otherwise, and for the hull vertices, it is removed and inserted again. p must not be the position of another vertex. Returns false, and leaves the mesh unchanged, if the vertex can not be removed (see `remove_vertex`).
+        bool move_vertex(IndexType i_vertex, const Point &p);
+
+        //! Move the vertex indices[k] to positions[k] for each k (the indices are distinct) : the moves are done along a Hilbert curve, those that keep the faces around the vertices counterclockwise come first and are followed by a single pass of flips, the other vertices are then removed and inserted again. Returns the number of vertices that could not be moved.
+        IndexType move_vertices(std::span<const IndexType> indices, std::span<const Point> positions);
 
         //! Flips the edge opposed to the vertex of local index i_edge within the face of index i_face.
         void flip_edge(IndexType i_face, IndexType i_edge);
 
-        void insert_vertices(const std::vector<Point>& vertices, int point_count=-1);
+        //! Delaunay triangulation of the `point_count` first points (all the points if -1). If `spatial_sort` is true, the points are inserted in a Biased Randomized Insertion Order along a Hilbert curve. Returns false, and leaves the mesh empty, if `progress` cancels the triangulation.
+        bool insert_vertices(const std::vector<Point>& vertices, int point_count=-1, bool spatial_sort=false, const ProgressCallback& progress=nullptr);
+
+        //! Same triangulation as `insert_vertices`, built in parallel : the points are split by median cuts into one part per thread, each part is triangulated concurrently and the parts are merged along their seams (thread_count = 0 uses every core).
+        bool insert_vertices_parallel(const std::vector<Point>& vertices, int point_count=-1, unsigned thread_count=0, const ProgressCallback& progress=nullptr);
+
+        //! Get the index of the vertex created for each point inserted by `insert_vertices` (the i-th entry corresponds to the i-th point). The entry of a point whose vertex is removed is set to 0 (the infinite vertex), `move_vertex` keeps the entries and `compact` remaps them.
+        inline const std::vector<IndexType> &point_vertex_indices() const { return m_point_vertex_indices; }
+
+        //! Returns true if i_face is an infinite faces, false otherwise. 
+        bool is_infinite_face(IndexType i_face) const;
+        bool is_infinite_face(Face face) const;
 
         //! Clear the data structure.
         void clear();
 
     private:
+        //! The benchmarks time the private steps of the insertion and of the Laplacian.
+        friend struct TMeshBenchmark;
+
+        //! Local index of a vertex of the face, inlined in the one-ring loops.
+        inline IndexType ring_index(IndexType i_vertex, IndexType i_face) const
+        {
+            const Face &face = m_faces[i_face];
+            return static_cast<IndexType>(face.Vertices[0]) == i_vertex ? 0 : (static_cast<IndexType>(face.Vertices[1]) == i_vertex ? 1 : 2);
+        }
+
         //! Calculate cotangente Laplacian value at vertex of index i_vertex.
         ScalarType laplacian(IndexType i_vertex);
 
         //! Calculate the normal of a vertex using the cotangent Laplacian.
         Vector laplacian_vector(IndexType i_vertex);
 
-        //! Locate the triangle that contains p : <in_a_face (infinite face excluded), <face index, edge index>>
-        std::pair<bool, std::pair<int, int>> locate_triangle(const Point& p) const;
+        //! Compute the cotangent weights and the lumped mass of the vertices.
+        void build_laplacian_operator();
+
+        //! Locate the triangle that contains p, walking from the face i_start : <in_a_face (infinite face excluded), <face index, edge index>>. The number of visited faces is added to steps.
+        std::pair<bool, std::pair<int, int>> locate_triangle(const Point& p, IndexType i_start, std::uint64_t &steps) const;
+
+        //! Choose the face from which the location of p starts, according to the locate strategy.
+        IndexType start_face(const Point& p);
 
-        //! Insert a point that is outside the mesh.
-        void insert_outside(const Point& p, IndexType i_face);
+        //! Insert a point that is outside the mesh, returns the index of its vertex.
+        IndexType insert_outside(const Point& p, IndexType i_face);
 
         //! Iterative delaunay triangulation
         void lawson(IndexType i_vertex);
 
-        //! Returns true if i_face is an infinite faces, false otherwise. 
-        bool is_infinite_face(IndexType i_face) const;
-        bool is_infinite_face(Face face) const;
+        //! Returns true if p is strictly inside the circumcircle of the face, or strictly beyond the hull edge (or inside it) of an infinite face.
+        bool in_conflict(const Point &p, IndexType i_face) const;
+
+        //! Bowyer-Watson insertion of p : the faces in conflict with p, connected to the face of index i_face (in conflict), are replaced by the faces joining p to the border of the hole. Their slots are reused, two faces are added. Returns the index of the vertex of p.
+        IndexType insert_cavity(const Point &p, IndexType i_face);
+
+        //! Get a slot for a new face : a free slot if there is one, a new face otherwise.
+        IndexType new_face();
+
+        //! Create a vertex of position p in a free slot if there is one, returns its index.
+        IndexType new_vertex(const Point &p, IndexType i_face);
+
+        //! Build the Delaunay hierarchy of the vertices if the locate strategy is Hierarchy, drop it otherwise.
+        void build_hierarchy();
+
+        //! Add the vertex i_lower of the level `level` of the hierarchy (0 is the mesh itself) to the levels above, as far as it is promoted.
+        void hierarchy_insert(IndexType level, IndexType i_lower);
+
+        //! Remove the vertex i_lower of the level `level` of the hierarchy from the levels above.
+        void hierarchy_remove(IndexType level, IndexType i_lower);
+
+        //! Move the copies of the vertices of the mesh in the levels of the hierarchy to their positions.
+        void hierarchy_move(std::vector<IndexType> &indices);
+
+        //! Get the face from which the walk locating p in the level `level` of the hierarchy starts : p is located in each level above, from the top, and each walk starts from the vertex below the nearest vertex of the face found above. The faces visited by these walks are added to steps.
+        IndexType hierarchy_start_face(const Point &p, IndexType level, std::uint64_t &steps) const;
+
+        //! Flip the edges <face index, edge index> of the stack (and the edges made suspicious by the flips) until they are all locally Delaunay.
+        void legalize(std::vector<std::pair<IndexType, IndexType>>& edges);
+
+        //! Returns true if the faces around the vertex stay counterclockwise when it moves to p, false for the vertices of the hull.
+        bool keeps_star(IndexType i_vertex, const Point &p) const;
+
+        //! Get the index of the inserted point of the vertex, or NO_POINT if it has none. The inverse of m_point_vertex_indices is built by the first call.
+        IndexType vertex_point_index(IndexType i_vertex);
+
+        //! Compute the missing neighbors (-1) of the faces from their vertices and set a face of each vertex. Returns false if an open edge is not shared by exactly two faces.
+        bool sew_faces();
 
         //! Use for infinite faces, they must have the infinite point (of index 0) as first vertex (local index 0). This method check if the infinite face is well constructed, if not it do the necessary operation. 
         void slide_triangle(IndexType i_face);
 
-        //! Splits a triangle face into three by insertion of a new vertex that is located at the position provided in parameter.
-        void triangle_split(const Point &p, IndexType i_face);
+        //! Splits a triangle face into three by insertion of a new vertex that is located at the position provided in parameter. Returns the index of the new vertex.
+        IndexType triangle_split(const Point &p, IndexType i_face);
 
-        //! Splits an edge into two by insertion of a new vertex that is located at the position provided in parameter. The incident faces are also divided into two faces.
-        void edge_split(const Point &p, IndexType i_face, IndexType i_edge);
+        //! Splits an edge into two by insertion of a new vertex that is located at the position provided in parameter. The incident faces are also divided into two faces. Returns the index of the new vertex.
+        IndexType edge_split(const Point &p, IndexType i_face, IndexType i_edge);
 
         //! Check if a face is well oriented (counter-clockwise), if not, it rearange the vertices.
         void check_orientation(Face& face);
@@ -141,7 +361,7 @@ namespace gam
 
     private:
         //! Vertices of the mesh.
-        std::vector<Vertex> m_vertices;
+        VertexArray m_vertices;
 
         //! Sewn-together faces of the mesh.
         std::vector<Face> m_faces;
@@ -152,7 +372,60 @@ namespace gam
         //! Vertices values (must be of the same size as m_vertices).
         std::vector<ScalarType> m_values;
 
+        //! Laplacian of the values, kept between the diffusion steps to reuse its memory.
+        std::vector<ScalarType> m_laplacian_values;
+
         //! Vertices curavture (must be of the same size as m_vertices).
         std::vector<ScalarType> m_curvature;
+
+        //! Cotangent Laplacian matrix and lumped mass, they must be rebuilt when m_operator_dirty is true.
+        SparseMatrix m_laplacian_operator;
+        std::vector<ScalarType> m_lumped_mass;
+        bool m_operator_dirty{true};
+
+        //! Convergence of the last implicit heat diffusion step.
+        SolverStats m_solver_stats;
+
+        //! Index of the vertex created for each point inserted by `insert_vertices`.
+        std::vector<IndexType> m_point_vertex_indices;
+
+        //! Inverse of m_point_vertex_indices, built by the first removal (the vertices inserted later have no entry).
+        std::vector<IndexType> m_vertex_point_indices;
+
+        //! Strategy used to choose the starting face of the point location.
+        LocateStrategy m_locate_strategy{LocateStrategy::LastInserted};
+
+        //! Algorithm used to insert the vertices.
+        InsertionEngine m_insertion_engine{InsertionEngine::Lawson};
+
+        //! Marks of the faces visited by insert_cavity : m_stamp for the faces of the current cavity, m_stamp + 1 for the faces outside of it.
+        std::vector<std::uint32_t> m_face_stamps;
+        std::uint32_t m_stamp{0};
+
+        //! Slots of the removed vertices and faces, reused by the insertions.
+        std::vector<IndexType> m_free_vertices;
+        std::vector<IndexType> m_free_faces;
+
+        //! Levels of the Delaunay hierarchy, from the bottom : the level k + 1 is m_hierarchy[k].
+        struct HierarchyLevel;
+        std::vector<HierarchyLevel> m_hierarchy;
+
+        //! Face of the last inserted vertex (or of the last removal).
+        IndexType m_last_face{0};
+
+        //! Random generator used to sample the vertices of the jump-and-walk.
+        std::default_random_engine m_rng;
+
+        //! Number of point locations and of faces visited by them.
+        std::uint64_t m_locate_count{0};
+        std::uint64_t m_walk_steps{0};
+    };
+
+    //! Triangulation of a random subset of the vertices of the level below : its vertex i is the vertex Down[i] below, and Up[j] is its vertex for the vertex j below (0 if j is not in the level). Until it has three vertices that are not aligned, the level has no face and Down lists the vertices below that it will contain.
+    struct TMesh::HierarchyLevel
+    {
+        TMesh Mesh;
+        std::vector<IndexType> Down;
+        std::vector<IndexType> Up;
     };
 } // namespace gam
\ No newline at end of file
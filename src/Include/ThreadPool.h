@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Utils.h"
+
+namespace gam
+{
+    //! Below this number of iterations, a loop is not split between threads.
+    constexpr IndexType PARALLEL_GRAIN = 2048;
+
+    //! Persistent worker threads running loops split in contiguous chunks. The chunks only depend on the number of threads, and each index is processed by a single thread.
+    class ThreadPool
+    {
+    public:
+        //! Create a pool of thread_count threads, the calling thread included (0 uses every core).
+        explicit ThreadPool(unsigned thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        //! Get the pool shared by the mesh kernels.
+        static ThreadPool &instance();
+
+        //! Set the number of threads, the calling thread included (0 uses every core).
+        void thread_count(unsigned count);
+
+        //! Get the number of threads, the calling thread included.
+        inline unsigned thread_count() const { return m_workers.size() + 1; }
+
+        //! Call task(begin, end) on contiguous chunks of [0, count) and wait for all of them. Small loops, and loops started from a task, run on the calling thread.
+        void parallel_for(IndexType count, const std::function<void(IndexType, IndexType)> &task, IndexType grain = PARALLEL_GRAIN);
+
+    private:
+        void start(unsigned count);
+        void stop();
+
+        //! Loop of the worker i_worker : runs the chunk i_worker + 1 of each task posted after `generation`.
+        void work(unsigned i_worker, std::uint64_t generation);
+
+    private:
+        std::vector<std::thread> m_workers;
+
+        //! Only one loop is distributed at a time.
+        std::mutex m_call_mutex;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        const std::function<void(IndexType, IndexType)> *m_task{nullptr};
+        IndexType m_count{0};
+        unsigned m_chunk_count{0};
+        std::uint64_t m_generation{0};
+        unsigned m_pending{0};
+        bool m_stop{false};
+    };
+
+    //! Run a loop on the shared thread pool, see ThreadPool::parallel_for.
+    inline void parallel_for(IndexType count, const std::function<void(IndexType, IndexType)> &task, IndexType grain = PARALLEL_GRAIN)
+    {
+        ThreadPool::instance().parallel_for(count, task, grain);
+    }
+} // namespace gam
@@ -5,15 +5,7 @@
 namespace gam
 {
     using ScalarType = float;
-    using IndexType = size_t;
-
-    struct HashEdgePair
-    {
-        IndexType operator()(const std::pair<IndexType, IndexType> &P) const
-        {
-            return P.first + P.second;
-        }
-    };
+    using IndexType = std::uint32_t;
 
     // struct Vector;
     // struct Vertex;
@@ -73,5 +65,18 @@ namespace utils
         std::cout << " !!" << std::endl;
     }
 
+    //! Directories prefixed to the file names given to the loaders and writers. They default to the directories set at configuration time, the command line driver empties them to use full paths.
+    struct DataDirectories
+    {
+        std::string Off{OFF_DIR};
+        std::string Obj{OBJ_DIR};
+        std::string Cloud{CLOUD_DIR};
+        std::string TMesh{TMESH_DIR};
+    };
+
+    //! Get the directories shared by the loaders and writers, they must be set before any file is read.
+    DataDirectories &data_directories();
+
+    //! Read a point cloud of the cloud directory (see gam::read_points for the formats) and scale its coordinates. Returns no points if the file can not be read.
     std::vector<Point> read_point_set(const std::string& filename, float x_scale = 1.0, float y_scale = 1.0, float z_scale = 1.0);
 } // namespace utils
@@ -2,10 +2,24 @@
 
 #include "App.h"
 #include "Framebuffer.h"
+#include "GpuMesh.h"
+#include "Instrumentation.h"
+#include "Job.h"
+#include "Predicates.h"
 #include "TMesh.h"
 #include "Timer.h"
 #include "Utils.h"
 
+//! Point cloud and its triangulation, built in the background by the Delaunay demo.
+struct DelaunayLoad
+{
+    std::vector<Point> Points;
+    int PointCount{0};
+    gam::TMesh Mesh;
+    int Ms{0};
+    int Us{0};
+};
+
 class Viewer : public App
 {
 public:
@@ -21,6 +35,15 @@ private:
     int init_laplacian_demo();
     int init_delaunay_demo();
 
+    //! Load the OFF mesh file_name for the Laplacian demo and compute its normals and curvature. The result is cached as a .tmesh file, reused while it is newer than the OFF file. Called from the loading job.
+    static std::optional<gam::TMesh> load_laplacian_mesh(const std::string &file_name, const gam::ProgressCallback &progress = nullptr);
+
+    //! Read the point cloud m_file_cloud and triangulate it in the background.
+    void start_delaunay_load();
+
+    //! Swap in the meshes built by the finished jobs.
+    void poll_jobs();
+
     int handle_events();
 
     int render_ui();
@@ -37,21 +60,28 @@ private:
     int render_demo_buttons();
     int render_menu_bar();
 
-    void set_infinite_z(Mesh& mesh, gam::TMesh& tmesh);
+    void set_infinite_z(GpuMesh& mesh, gam::TMesh& tmesh);
 
 private:
     Mesh m_grid;
-    Mesh m_object;
     Mesh m_repere;
-    Mesh m_object2;
+
+    //! Buffers drawn by the demos, updated in place when the meshes change.
+    GpuMesh m_object;
+    GpuMesh m_object2;
 
     gam::TMesh m_laplacian;
     gam::TMesh m_delaunay;
 
+    //! The meshes are loaded on worker threads and replace m_laplacian and m_delaunay when they are complete.
+    gam::Job<gam::TMesh> m_laplacian_job;
+    gam::Job<DelaunayLoad> m_delaunay_job;
+
     GLuint m_program;
     GLuint m_program_2;
     GLuint m_program_edges;
     GLuint m_program_points;
+    GLuint m_program_normals;
     GLuint m_heat_diffusion_tex;
 
     std::string m_saved_file;
@@ -81,6 +111,8 @@ private:
     bool m_show_normals{false};
     bool m_show_curvature{false};
     bool m_show_heat_diffusion{false};
+    bool m_implicit_diffusion{false};
+    float m_diffusion_time_step{0.001f};
     bool m_show_normal_color{false};
     bool m_show_smooth_normal{false};
 
@@ -90,7 +122,13 @@ private:
 
     bool m_show_infinite_faces{false};
     bool m_shuffle{true};
+    bool m_spatial_sort{false};
+    int m_thread_count{1};
+
+    int m_locate_strategy{static_cast<int>(gam::LocateStrategy::LastInserted)};
+    int m_insertion_engine{static_cast<int>(gam::InsertionEngine::Lawson)};
     
+    //! Format of the saved mesh : 0 OFF, 1 OBJ, 2 TMESH.
     int m_save_as_obj{1};
 
     int m_dttms{0}; //! Delaunay Triangulation Time (ms)
@@ -6,14 +6,21 @@
 #include <algorithm>
 #include <functional>
 #include <variant>
+#include <optional>
 #include <random>
 #include <limits>
+#include <numeric>
 
 #include <utility>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <sstream>
+#include <iomanip>
 #include <array>
+#include <span>
 #include <set>
+#include <map>
 #include <stack>
 #include <vector>
 #include <unordered_map>
@@ -23,8 +30,16 @@
 #include <ranges>
 #include <cassert>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <cstdio>
+#include <ctime>
+#include <cstring>
+#include <filesystem>
 
+#ifndef GAM_HEADLESS
 // ImGUI 
 #include "imgui.h"
 #include "imgui_stdlib.h"
@@ -44,3 +59,9 @@
 #include "wavefront.h"
 
 #include <SDL2/SDL.h>
+#else
+// GKit maths only : the headless build has no window nor GL context.
+#include "vec.h"
+#include "mat.h"
+#include "color.h"
+#endif
@@ -202,6 +202,11 @@ void App::center_camera(const Mesh &mesh)
     m_camera.lookat(pmin, pmax);
 }
 
+void App::center_camera(const std::pair<Point, Point> &bounds)
+{
+    m_camera.lookat(bounds.first, bounds.second);
+}
+
 void App::vsync_off()
 {
     // desactive vsync pour les mesures de temps
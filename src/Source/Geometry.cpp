@@ -1,5 +1,7 @@
 #include "Geometry.h"
 
+#include "Predicates.h"
+
 namespace gam
 {
 
@@ -17,7 +19,7 @@ namespace gam
 
     int orientation(const Point &p, const Point &q, const Point &r)
     {
-        ScalarType s = (q.x - p.x) * (r.y - p.y) - (q.y - p.y) * (r.x - p.x);
+        double s = orient2d(p.x, p.y, q.x, q.y, r.x, r.y);
 
         return s > 0.0 ? 1 : s < 0.0 ? -1
                                      : 0;
@@ -56,21 +58,34 @@ namespace gam
 
     bool in_circle(const Point &p, const Point &a, const Point &b, const Point &c)
     {
-        ScalarType c00 = b.x - a.x;
-        ScalarType c01 = c.x - a.x;
-        ScalarType c02 = p.x - a.x;
+        return incircle(a.x, a.y, b.x, b.y, c.x, c.y, p.x, p.y) >= 0;
+    }
 
-        ScalarType c10 = b.y - a.y;
-        ScalarType c11 = c.y - a.y;
-        ScalarType c12 = p.y - a.y;
+    int circle_side(const Point &p, const Point &a, const Point &b, const Point &c)
+    {
+        double s = incircle(a.x, a.y, b.x, b.y, c.x, c.y, p.x, p.y);
 
-        ScalarType c20 = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
-        ScalarType c21 = (c.x - a.x) * (c.x - a.x) + (c.y - a.y) * (c.y - a.y);
-        ScalarType c22 = (p.x - a.x) * (p.x - a.x) + (p.y - a.y) * (p.y - a.y);
+        return s > 0.0 ? 1 : s < 0.0 ? -1
+                                     : 0;
+    }
 
-        ScalarType d = c00 * det(c11, c12, c21, c22) - c01 * det(c10, c12, c20, c22) + c02 * det(c10, c11, c20, c21);
+    bool circumcircle(const Point &a, const Point &b, const Point &c, double &cx, double &cy, double &r)
+    {
+        double bx = double(b.x) - a.x, by = double(b.y) - a.y;
+        double qx = double(c.x) - a.x, qy = double(c.y) - a.y;
+        double d = 2. * (bx * qy - by * qx);
+        if (d == 0.)
+            return false;
 
-        return d <= 0;
+        double b2 = bx * bx + by * by;
+        double q2 = qx * qx + qy * qy;
+        double ux = (qy * b2 - by * q2) / d;
+        double uy = (bx * q2 - qx * b2) / d;
+
+        cx = a.x + ux;
+        cy = a.y + uy;
+        r = std::sqrt(ux * ux + uy * uy);
+        return true;
     }
 
     ScalarType det(ScalarType i, ScalarType j, ScalarType k, ScalarType l)
@@ -92,6 +107,50 @@ namespace gam
         return out;
     }
 
+    void VertexArray::reserve(IndexType count)
+    {
+        X.reserve(count);
+        Y.reserve(count);
+        Z.reserve(count);
+        FaceIndex.reserve(count);
+    }
+
+    void VertexArray::resize(IndexType count)
+    {
+        X.resize(count, 0);
+        Y.resize(count, 0);
+        Z.resize(count, 0);
+        FaceIndex.resize(count, -1);
+    }
+
+    void VertexArray::clear()
+    {
+        X.clear();
+        Y.clear();
+        Z.clear();
+        FaceIndex.clear();
+    }
+
+    void VertexArray::emplace_back(const Point &point, int i_face)
+    {
+        emplace_back(point.x, point.y, point.z, i_face);
+    }
+
+    void VertexArray::emplace_back(ScalarType x, ScalarType y, ScalarType z, int i_face)
+    {
+        X.emplace_back(x);
+        Y.emplace_back(y);
+        Z.emplace_back(z);
+        FaceIndex.emplace_back(i_face);
+    }
+
+    void VertexArray::position(IndexType i, const Point &point)
+    {
+        X[i] = point.x;
+        Y[i] = point.y;
+        Z[i] = point.z;
+    }
+
     Face::Face(int v0, int v1, int v2, int n0, int n1, int n2)
     {
         vertices(v0, v1, v2);
@@ -160,7 +219,7 @@ namespace gam
     {
         for (auto &n : Neighbors)
         {
-            if (n == i_face)
+            if (n == static_cast<int>(i_face))
             {
                 n = value;
                 break;
@@ -172,7 +231,7 @@ namespace gam
     {
         for (int i = 0; i < 3; ++i)
         {
-            if (Neighbors[i] == i_face)
+            if (Neighbors[i] == static_cast<int>(i_face))
                 return i;
         }
 
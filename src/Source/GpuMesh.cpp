@@ -0,0 +1,216 @@
+#include "GpuMesh.h"
+
+//! Attribute locations used by the shaders.
+enum AttributeLocation : GLuint
+{
+    POSITION_LOCATION = 0,
+    VALUE_LOCATION = 1,
+    NORMAL_LOCATION = 2,
+};
+
+//! Two dirty ranges separated by fewer clean elements are sent in a single call.
+constexpr std::size_t MERGE_GAP = 64;
+
+void GpuMesh::update(const gam::TMesh &mesh, bool curvature, bool remove_infinite)
+{
+    if (m_vao == 0)
+        create();
+    glBindVertexArray(m_vao);
+    m_uploaded_bytes = 0;
+
+    // Positions
+    const gam::VertexArray &vertices = mesh.vertices();
+    m_vertex_count = vertices.size();
+    m_position_staging.resize(m_vertex_count);
+    mesh.export_positions(m_position_staging);
+    m_pmin = Point(FLT_MAX, FLT_MAX, FLT_MAX);
+    m_pmax = Point(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (const vec3 &position : m_position_staging)
+    {
+        m_pmin = min(m_pmin, Point(position));
+        m_pmax = max(m_pmax, Point(position));
+    }
+    m_uploaded_bytes += upload(m_positions, GL_ARRAY_BUFFER, m_position_staging.data(), m_vertex_count, sizeof(vec3));
+
+    // Scalar channel
+    const auto &values = curvature && !mesh.curvatures().empty() ? mesh.curvatures() : mesh.vertices_values();
+    m_uploaded_bytes += upload(m_values, GL_ARRAY_BUFFER, values.data(), values.size(), sizeof(float));
+    attribute(VALUE_LOCATION, values.size() == vertices.size(), 0.f, 0.f, 0.f);
+
+    // Normals
+    const auto &normals = mesh.normals();
+    m_uploaded_bytes += upload(m_normals, GL_ARRAY_BUFFER, normals.data(), normals.size(), sizeof(Vector));
+    attribute(NORMAL_LOCATION, normals.size() == vertices.size(), 0.f, 0.f, 1.f);
+
+    // Triangles
+    const auto &faces = mesh.faces();
+    m_index_count = 3 * faces.size();
+    m_index_staging.resize(m_index_count);
+    m_triangle_count = mesh.export_triangles(m_index_staging, remove_infinite, true);
+    m_uploaded_bytes += upload(m_indices, GL_ELEMENT_ARRAY_BUFFER, m_index_staging.data(), faces.size(), 3 * sizeof(std::uint32_t));
+
+    // Edges, 3 slots per face
+    glBindVertexArray(m_edge_vao);
+    m_edge_staging.resize(6 * faces.size());
+    m_edge_count = mesh.export_edges(m_edge_staging, remove_infinite, true);
+    m_uploaded_bytes += upload(m_edges, GL_ELEMENT_ARRAY_BUFFER, m_edge_staging.data(), faces.size(), 6 * sizeof(std::uint32_t));
+}
+
+void GpuMesh::update_values(const gam::TMesh &mesh, bool curvature)
+{
+    if (m_vao == 0)
+    {
+        update(mesh, curvature);
+        return;
+    }
+
+    const auto &values = curvature && !mesh.curvatures().empty() ? mesh.curvatures() : mesh.vertices_values();
+    std::size_t size = values.size() * sizeof(float);
+
+    // Orphaning : the driver gives a new storage instead of waiting for the draws that read the previous values.
+    glBindBuffer(GL_ARRAY_BUFFER, m_values.Id);
+    m_values.Capacity = std::max(m_values.Capacity, size);
+    glBufferData(GL_ARRAY_BUFFER, m_values.Capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, size, values.data());
+
+    auto bytes = reinterpret_cast<const char *>(values.data());
+    m_values.Shadow.assign(bytes, bytes + size);
+    m_uploaded_bytes = size;
+
+    glBindVertexArray(m_vao);
+    attribute(VALUE_LOCATION, values.size() == static_cast<std::size_t>(m_vertex_count), 0.f, 0.f, 0.f);
+}
+
+void GpuMesh::draw_triangles() const
+{
+    if (m_vao == 0 || m_index_count == 0)
+        return;
+
+    glBindVertexArray(m_vao);
+    glDrawElements(GL_TRIANGLES, m_index_count, GL_UNSIGNED_INT, nullptr);
+}
+
+void GpuMesh::draw_edges() const
+{
+    if (m_edge_vao == 0 || m_edge_staging.empty())
+        return;
+
+    glBindVertexArray(m_edge_vao);
+    glDrawElements(GL_LINES, m_edge_staging.size(), GL_UNSIGNED_INT, nullptr);
+}
+
+void GpuMesh::draw_points() const
+{
+    if (m_vao == 0 || m_vertex_count == 0)
+        return;
+
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_POINTS, 0, m_vertex_count);
+}
+
+void GpuMesh::release()
+{
+    for (Buffer *buffer : {&m_positions, &m_values, &m_normals, &m_indices, &m_edges})
+    {
+        if (buffer->Id != 0)
+            glDeleteBuffers(1, &buffer->Id);
+        *buffer = Buffer();
+    }
+    for (GLuint *vao : {&m_vao, &m_edge_vao})
+    {
+        if (*vao != 0)
+            glDeleteVertexArrays(1, vao);
+        *vao = 0;
+    }
+    m_edge_staging.clear();
+    m_vertex_count = m_triangle_count = m_index_count = m_edge_count = 0;
+}
+
+void GpuMesh::create()
+{
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    for (Buffer *buffer : {&m_positions, &m_values, &m_normals, &m_indices, &m_edges})
+        glGenBuffers(1, &buffer->Id);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_positions.Id);
+    glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray(POSITION_LOCATION);
+
+    // A single float per vertex : the shaders read it as texcoord.x.
+    glBindBuffer(GL_ARRAY_BUFFER, m_values.Id);
+    glVertexAttribPointer(VALUE_LOCATION, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_normals.Id);
+    glVertexAttribPointer(NORMAL_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices.Id);
+
+    glGenVertexArrays(1, &m_edge_vao);
+    glBindVertexArray(m_edge_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_positions.Id);
+    glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glEnableVertexAttribArray(POSITION_LOCATION);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_edges.Id);
+
+    glBindVertexArray(m_vao);
+}
+
+std::size_t GpuMesh::upload(Buffer &buffer, GLenum target, const void *data, std::size_t count, std::size_t element_size)
+{
+    auto bytes = static_cast<const char *>(data);
+    std::size_t size = count * element_size;
+    glBindBuffer(target, buffer.Id);
+
+    // The buffer grows geometrically, so that appending vertices or faces does not reallocate it each time.
+    if (size > buffer.Capacity)
+    {
+        buffer.Capacity = std::max(size, 2 * buffer.Capacity);
+        glBufferData(target, buffer.Capacity, nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(target, 0, size, bytes);
+        buffer.Shadow.assign(bytes, bytes + size);
+        return size;
+    }
+
+    std::size_t sent_count = buffer.Shadow.size() / element_size;
+    buffer.Shadow.resize(size);
+    auto dirty = [&](std::size_t i)
+    { return i >= sent_count || std::memcmp(&buffer.Shadow[i * element_size], bytes + i * element_size, element_size) != 0; };
+
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!dirty(i))
+            continue;
+
+        // Extend the range over short runs of clean elements.
+        std::size_t last_dirty = i;
+        for (std::size_t j = i + 1; j < count && j - last_dirty <= MERGE_GAP; ++j)
+        {
+            if (dirty(j))
+                last_dirty = j;
+        }
+
+        std::size_t offset = i * element_size;
+        std::size_t length = (last_dirty + 1 - i) * element_size;
+        glBufferSubData(target, offset, length, bytes + offset);
+        std::memcpy(&buffer.Shadow[offset], bytes + offset, length);
+        sent += length;
+        i = last_dirty;
+    }
+    return sent;
+}
+
+void GpuMesh::attribute(GLuint location, bool enabled, float fallback_x, float fallback_y, float fallback_z)
+{
+    if (enabled)
+    {
+        glEnableVertexAttribArray(location);
+    }
+    else
+    {
+        glDisableVertexAttribArray(location);
+        glVertexAttrib3f(location, fallback_x, fallback_y, fallback_z);
+    }
+}
@@ -0,0 +1,148 @@
+#include "Instrumentation.h"
+
+namespace gam
+{
+    const char *counter_name(Counter counter)
+    {
+        static constexpr std::array<const char *, COUNTER_COUNT> names{
+            "locates", "walk_steps", "lawson_calls", "lawson_flips", "flips", "triangle_splits", "edge_splits", "insert_outside", "hull_walk_steps", "cavities", "cavity_faces", "vertex_removals", "removal_faces", "vertex_moves", "move_reinsertions"};
+        return names[static_cast<std::size_t>(counter)];
+    }
+
+#ifdef GAM_INSTRUMENTATION
+    namespace instrumentation
+    {
+        struct TraceEvent
+        {
+            const char *Name;
+            //! Start and duration, in us since the start of the program.
+            double Start;
+            double Duration;
+        };
+
+        //! Counters and scopes of a thread, kept after the end of the thread.
+        struct ThreadData
+        {
+            std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> Counters{};
+
+            //! Only contended while the trace is written.
+            std::mutex Mutex;
+            std::vector<TraceEvent> Events;
+            unsigned Id{0};
+        };
+
+        static const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+        static std::mutex s_threads_mutex;
+        static std::vector<std::shared_ptr<ThreadData>> s_threads;
+
+        static ThreadData &thread_data()
+        {
+            static thread_local std::shared_ptr<ThreadData> data = []()
+            {
+                auto data = std::make_shared<ThreadData>();
+                std::lock_guard lock(s_threads_mutex);
+                data->Id = s_threads.size();
+                s_threads.push_back(data);
+                return data;
+            }();
+            return *data;
+        }
+
+        std::atomic<std::uint64_t> *thread_counters()
+        {
+            return thread_data().Counters.data();
+        }
+
+        Scope::~Scope()
+        {
+            auto stop = std::chrono::steady_clock::now();
+            ThreadData &data = thread_data();
+            std::lock_guard lock(data.Mutex);
+            data.Events.push_back({m_name, std::chrono::duration<double, std::micro>(m_start - s_epoch).count(),
+                                   std::chrono::duration<double, std::micro>(stop - m_start).count()});
+        }
+    } // namespace instrumentation
+
+    InstrumentationStats instrumentation_stats()
+    {
+        InstrumentationStats stats;
+        std::lock_guard lock(instrumentation::s_threads_mutex);
+        for (const auto &thread : instrumentation::s_threads)
+        {
+            for (std::size_t i = 0; i < COUNTER_COUNT; ++i)
+                stats.Values[i] += thread->Counters[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void reset_instrumentation_stats()
+    {
+        std::lock_guard lock(instrumentation::s_threads_mutex);
+        for (const auto &thread : instrumentation::s_threads)
+        {
+            for (auto &counter : thread->Counters)
+                counter.store(0, std::memory_order_relaxed);
+
+            std::lock_guard events_lock(thread->Mutex);
+            thread->Events.clear();
+        }
+    }
+
+    bool write_chrome_trace(const std::string &filename)
+    {
+        std::ofstream file(filename);
+        if (!file.is_open())
+        {
+            utils::error("in [write_chrome_trace] Couldn't create this file: ", filename);
+            return false;
+        }
+
+        // Complete events ("ph" : "X"), one track per thread.
+        file << "{\"traceEvents\":[";
+        bool first = true;
+        {
+            std::lock_guard lock(instrumentation::s_threads_mutex);
+            for (const auto &thread : instrumentation::s_threads)
+            {
+                std::lock_guard events_lock(thread->Mutex);
+                for (const auto &event : thread->Events)
+                {
+                    file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.Name << "\",\"cat\":\"gam\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->Id
+                         << ",\"ts\":" << std::fixed << std::setprecision(3) << event.Start << ",\"dur\":" << event.Duration << "}";
+                    first = false;
+                }
+            }
+        }
+
+        InstrumentationStats stats = instrumentation_stats();
+        file << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{";
+        for (std::size_t i = 0; i < COUNTER_COUNT; ++i)
+            file << (i == 0 ? "" : ",") << "\"" << counter_name(static_cast<Counter>(i)) << "\":" << stats.Values[i];
+        file << "}}\n";
+
+        if (!file)
+        {
+            utils::error("in [write_chrome_trace] Couldn't write this file: ", filename);
+            return false;
+        }
+        utils::status("Trace successfully saved in ", filename);
+        return true;
+    }
+#else
+    InstrumentationStats instrumentation_stats()
+    {
+        return {};
+    }
+
+    void reset_instrumentation_stats()
+    {
+    }
+
+    bool write_chrome_trace(const std::string &filename)
+    {
+        utils::error("in [write_chrome_trace] ", filename, " not written : built without GAM_INSTRUMENTATION");
+        return false;
+    }
+#endif
+} // namespace gam
@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gam
+{
+    MappedFile::MappedFile(const std::string &filename)
+    {
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd == -1)
+            return;
+
+        struct stat info;
+        if (fstat(fd, &info) == 0)
+        {
+            m_open = true;
+            m_size = info.st_size;
+            if (m_size > 0)
+            {
+                void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    madvise(data, m_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<const char *>(data);
+                    m_mapped = true;
+                }
+            }
+        }
+        close(fd);
+
+        if (m_mapped || !m_open)
+            return;
+#endif
+        // The file could not be mapped : its content is read into memory.
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+        {
+            m_open = false;
+            return;
+        }
+        m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+        m_open = true;
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifndef _WIN32
+        if (m_mapped)
+            munmap(const_cast<char *>(m_data), m_size);
+#endif
+    }
+
+    bool TextReader::keyword(std::string_view keyword)
+    {
+        skip_blanks();
+        const char *word_end = m_current;
+        while (word_end < m_end && !std::isspace(static_cast<unsigned char>(*word_end)))
+            word_end++;
+
+        bool found = std::string_view(m_current, word_end - m_current) == keyword;
+        if (found)
+            m_current = word_end;
+        return found;
+    }
+
+    bool TextReader::at_end()
+    {
+        skip_blanks();
+        return m_current == m_end;
+    }
+
+    IndexType TextReader::line() const
+    {
+        return std::count(m_begin, m_current, '\n') + 1;
+    }
+
+    void TextReader::skip_blanks()
+    {
+        while (m_current < m_end)
+        {
+            if (*m_current == '#')
+            {
+                while (m_current < m_end && *m_current != '\n')
+                    m_current++;
+            }
+            else if (std::isspace(static_cast<unsigned char>(*m_current)))
+            {
+                m_current++;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+} // namespace gam
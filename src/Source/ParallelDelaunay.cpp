@@ -0,0 +1,315 @@
+#include "TMesh.h"
+#include "Instrumentation.h"
+
+namespace gam
+{
+    /*
+     * Divide and conquer construction of the Delaunay triangulation.
+     *
+     * The points are split by median cuts into one part per thread and each part is triangulated concurrently.
+     * A triangle of a part whose circumcircle lies strictly inside the region of the part cannot contain a point of
+     * another part : it belongs to the global triangulation, it is final. A vertex whose faces are all final has the
+     * same star in the global triangulation, so the missing triangles only use the remaining (seam) vertices.
+     * They are the triangles of the triangulation of the seam vertices that do not overlap a final triangle.
+     */
+
+    //! Below this number of points per thread, the sequential construction is used.
+    constexpr IndexType PARALLEL_MIN_POINTS = 4096;
+
+    struct Part
+    {
+        //! Index of the points of the part.
+        std::vector<IndexType> Points;
+
+        //! Region of the part : [Min[0], Max[0]] x [Min[1], Max[1]].
+        double Min[2]{-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+        double Max[2]{std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+
+        TMesh Mesh;
+
+        //! Final faces of the part mesh.
+        std::vector<bool> Final;
+    };
+
+    //! Recursively split the points [begin, end) by median cuts along the largest side of their bounding box.
+    static void split(const std::vector<Point> &points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end, const Part &region, unsigned part_count, std::vector<Part> &parts)
+    {
+        if (part_count == 1)
+        {
+            Part &part = parts.emplace_back(region);
+            part.Points.assign(begin, end);
+            return;
+        }
+
+        ScalarType min[2]{std::numeric_limits<ScalarType>::max(), std::numeric_limits<ScalarType>::max()};
+        ScalarType max[2]{std::numeric_limits<ScalarType>::lowest(), std::numeric_limits<ScalarType>::lowest()};
+        for (auto it = begin; it != end; ++it)
+        {
+            min[0] = std::min(min[0], points[*it].x);
+            min[1] = std::min(min[1], points[*it].y);
+            max[0] = std::max(max[0], points[*it].x);
+            max[1] = std::max(max[1], points[*it].y);
+        }
+        int axis = max[0] - min[0] >= max[1] - min[1] ? 0 : 1;
+
+        unsigned left_count = part_count / 2;
+        auto middle = begin + (end - begin) * left_count / part_count;
+        std::nth_element(begin, middle, end, [&](IndexType i, IndexType j)
+                         { return axis == 0 ? points[i].x < points[j].x : points[i].y < points[j].y; });
+        double cut = axis == 0 ? points[*middle].x : points[*middle].y;
+
+        Part left = region, right = region;
+        left.Max[axis] = cut;
+        right.Min[axis] = cut;
+
+        split(points, begin, middle, left, left_count, parts);
+        split(points, middle, end, right, part_count - left_count, parts);
+    }
+
+    //! Returns true if the circumcircle of (a, b, c) lies strictly inside the region of the part, with a safety margin for the rounding errors.
+    static bool inside_region(const Part &part, const Point &a, const Point &b, const Point &c)
+    {
+        double cx, cy, r;
+        if (!circumcircle(a, b, c, cx, cy, r))
+            return false;
+
+        double margin = r + 1e-6 * (std::abs(cx) + std::abs(cy) + r);
+        return cx - margin > part.Min[0] && cx + margin < part.Max[0] &&
+               cy - margin > part.Min[1] && cy + margin < part.Max[1];
+    }
+
+    bool TMesh::insert_vertices_parallel(const std::vector<Point> &points, int point_count, unsigned thread_count, const ProgressCallback &progress)
+    {
+        GAM_TRACE_SCOPE("insert_vertices_parallel");
+        if (point_count == -1)
+            point_count = points.size();
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+        thread_count = std::min<unsigned>(thread_count, point_count / PARALLEL_MIN_POINTS);
+        if (thread_count <= 1)
+            return insert_vertices(points, point_count, true, progress);
+
+        clear();
+
+        std::vector<IndexType> indices(point_count);
+        std::iota(indices.begin(), indices.end(), IndexType(0));
+
+        std::vector<Part> parts;
+        parts.reserve(thread_count);
+        split(points, indices.begin(), indices.end(), Part(), thread_count, parts);
+
+        // Part and local vertex of each global vertex.
+        std::vector<std::pair<unsigned, IndexType>> owners(point_count + 1);
+
+        // The parts report to `progress` in turn, their triangulation is the first 90 % of the work.
+        std::mutex progress_mutex;
+        std::vector<float> part_progress(parts.size(), 0.f);
+        std::atomic<bool> cancelled{false};
+        auto part_callback = [&](unsigned i_part) -> ProgressCallback
+        {
+            if (!progress)
+                return nullptr;
+            return [&, i_part](float value)
+            {
+                std::lock_guard lock(progress_mutex);
+                part_progress[i_part] = value;
+                float total = std::accumulate(part_progress.begin(), part_progress.end(), 0.f) / part_progress.size();
+                if (!cancelled && !progress(0.9f * total))
+                    cancelled = true;
+                return !cancelled;
+            };
+        };
+
+        // Triangulate each part and find its final faces.
+        std::vector<std::thread> threads;
+        for (unsigned i_part = 0; i_part < parts.size(); ++i_part)
+        {
+            threads.emplace_back([&points, &part = parts[i_part], &owners, i_part, engine = m_insertion_engine, callback = part_callback(i_part)]()
+                                 {
+                GAM_TRACE_SCOPE("triangulate_part");
+                part.Mesh.insertion_engine(engine);
+                std::vector<Point> part_points;
+                part_points.reserve(part.Points.size());
+                for (IndexType i : part.Points)
+                    part_points.emplace_back(points[i].x, points[i].y, 0.);
+
+                if (!part.Mesh.insert_vertices(part_points, -1, true, callback))
+                    return;
+
+                // The part mesh vertices are renamed with the global index of the vertices (the vertex i + 1 is created for the point i).
+                std::vector<IndexType> global(part.Mesh.vertex_count(), 0);
+                const auto &vertex_indices = part.Mesh.point_vertex_indices();
+                for (IndexType i = 0; i < part.Points.size(); ++i)
+                {
+                    global[vertex_indices[i]] = part.Points[i] + 1;
+                    owners[part.Points[i] + 1] = {i_part, vertex_indices[i]};
+                }
+
+                part.Final.resize(part.Mesh.face_count());
+                for (IndexType i_face = 0; i_face < part.Mesh.face_count(); ++i_face)
+                {
+                    const Face &face = part.Mesh.m_faces[i_face];
+                    part.Final[i_face] = !part.Mesh.is_infinite_face(i_face) &&
+                                         inside_region(part, part.Mesh.m_vertices.point(face[0]),
+                                                       part.Mesh.m_vertices.point(face[1]),
+                                                       part.Mesh.m_vertices.point(face[2]));
+                }
+
+                part.Points = std::move(global); });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        if (cancelled)
+        {
+            clear();
+            return false;
+        }
+
+        // The rest of the construction, sequential.
+        GAM_TRACE_SCOPE("merge_parts");
+
+        // Seam vertices : vertices of a face which is not final (infinite faces included).
+        std::vector<bool> seam(point_count + 1, false);
+        for (const auto &part : parts)
+        {
+            for (IndexType i_face = 0; i_face < part.Mesh.face_count(); ++i_face)
+            {
+                if (part.Final[i_face])
+                    continue;
+                for (int i = 0; i < 3; ++i)
+                    seam[part.Points[part.Mesh.m_faces[i_face][i]]] = true;
+            }
+        }
+
+        std::vector<IndexType> seam_vertices;
+        std::vector<Point> seam_points;
+        for (IndexType i_vertex = 1; i_vertex <= static_cast<IndexType>(point_count); ++i_vertex)
+        {
+            if (!seam[i_vertex])
+                continue;
+            seam_vertices.emplace_back(i_vertex);
+            seam_points.emplace_back(points[i_vertex - 1].x, points[i_vertex - 1].y, 0.);
+        }
+
+        TMesh seam_mesh;
+        seam_mesh.insertion_engine(m_insertion_engine);
+        seam_mesh.insert_vertices(seam_points, -1, true);
+        std::vector<IndexType> seam_global(seam_mesh.vertex_count(), 0);
+        for (IndexType i = 0; i < seam_vertices.size(); ++i)
+            seam_global[seam_mesh.point_vertex_indices()[i]] = seam_vertices[i];
+
+        // Global mesh : infinite vertex, then the vertex i + 1 for the point i.
+        m_vertices.reserve(point_count + 1);
+        m_vertices.emplace_back(0., 0., -1., 1);
+        for (int i = 0; i < point_count; ++i)
+            m_vertices.emplace_back(points[i].x, points[i].y, 0.);
+
+        // The final faces keep their adjacency inside their part, the other edges are sewn afterwards.
+        for (const auto &part : parts)
+        {
+            std::vector<int> global_faces(part.Mesh.face_count(), -1);
+            for (IndexType i_face = 0, i_global = face_count(); i_face < part.Mesh.face_count(); ++i_face)
+            {
+                if (part.Final[i_face])
+                    global_faces[i_face] = i_global++;
+            }
+
+            for (IndexType i_face = 0; i_face < part.Mesh.face_count(); ++i_face)
+            {
+                if (!part.Final[i_face])
+                    continue;
+                const Face &face = part.Mesh.m_faces[i_face];
+                m_faces.emplace_back(part.Points[face[0]], part.Points[face[1]], part.Points[face[2]],
+                                     global_faces[face(0)], global_faces[face(1)], global_faces[face(2)]);
+            }
+        }
+
+        // Triangles of the seam mesh that are not covered by final triangles (their centroid is not in a final triangle).
+        std::vector<int> seam_faces(seam_mesh.face_count(), -1);
+        for (IndexType i_face = 0, i_global = face_count(); i_face < seam_mesh.face_count(); ++i_face)
+        {
+            const Face &face = seam_mesh.m_faces[i_face];
+            if (!seam_mesh.is_infinite_face(i_face))
+            {
+                Point a = seam_mesh.m_vertices.point(face[0]);
+                Point b = seam_mesh.m_vertices.point(face[1]);
+                Point c = seam_mesh.m_vertices.point(face[2]);
+                Point centroid((a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3, 0.);
+
+                bool covered = false;
+                for (unsigned i_part = 0; i_part < parts.size(); ++i_part)
+                {
+                    Part &part = parts[i_part];
+                    if (centroid.x < part.Min[0] || centroid.x > part.Max[0] || centroid.y < part.Min[1] || centroid.y > part.Max[1])
+                        continue;
+
+                    // The walk starts next to the triangle when one of its vertices belongs to the part.
+                    IndexType i_start = part.Mesh.start_face(centroid);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto [i_owner, i_vertex] = owners[seam_global[face[i]]];
+                        if (i_owner == i_part)
+                            i_start = part.Mesh.m_vertices.FaceIndex[i_vertex];
+                    }
+
+                    std::uint64_t steps = 0;
+                    auto [found, location] = part.Mesh.locate_triangle(centroid, i_start, steps);
+                    covered = covered || (found && part.Final[location.first]);
+                }
+                if (covered)
+                    continue;
+            }
+
+            seam_faces[i_face] = i_global++;
+        }
+
+        std::vector<std::pair<IndexType, IndexType>> seam_edges;
+        for (IndexType i_face = 0; i_face < seam_mesh.face_count(); ++i_face)
+        {
+            if (seam_faces[i_face] == -1)
+                continue;
+
+            for (int i = 0; i < 3; ++i)
+                seam_edges.emplace_back(m_faces.size(), i);
+
+            const Face &face = seam_mesh.m_faces[i_face];
+            m_faces.emplace_back(seam_global[face[0]], seam_global[face[1]], seam_global[face[2]],
+                                 seam_faces[face(0)], seam_faces[face(1)], seam_faces[face(2)]);
+        }
+
+        if (!sew_faces())
+        {
+            utils::error("in [insert_vertices_parallel] The parts could not be merged, falling back to the sequential construction");
+            return insert_vertices(points, point_count, true, progress);
+        }
+
+        // The seam triangles are Delaunay for exact predicates and points in general position : this only fixes cocircular configurations.
+        legalize(seam_edges);
+
+        m_point_vertex_indices.resize(point_count);
+        std::iota(m_point_vertex_indices.begin(), m_point_vertex_indices.end(), IndexType(1));
+
+        m_values.reserve(point_count + 1);
+        m_values.emplace_back(0.);
+        for (int i = 0; i < point_count; ++i)
+            m_values.emplace_back(points[i].z);
+
+        m_last_face = m_vertices.FaceIndex.back();
+
+#ifndef NDEBUG
+        integrity_check();
+        utils::status("[insert_vertices_parallel] Integrity_check passed");
+        delaunay_check();
+        utils::status("[insert_vertices_parallel] Delaunay_check passed");
+#endif
+
+        std::copy(m_values.begin() + 1, m_values.end(), m_vertices.Z.begin() + 1);
+        build_hierarchy();
+
+        if (progress)
+            progress(1.f);
+        return true;
+    }
+} // namespace gam
@@ -0,0 +1,312 @@
+#include "PointCloud.h"
+
+#include "Instrumentation.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+namespace gam
+{
+    //! Size of the chunks of text parsed by a task.
+    constexpr std::size_t TEXT_CHUNK_SIZE = 1 << 20;
+
+    namespace
+    {
+        //! Layout of the numbers of a point in a text or binary record.
+        struct PointLayout
+        {
+            //! Numbers of a point, x y z included.
+            IndexType PropertyCount{3};
+            //! Property index of x, y and z (-1 : z is 0).
+            int Coordinates[3]{0, 1, 2};
+        };
+
+        template <typename T>
+        double load(const char *data)
+        {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return static_cast<double>(value);
+        }
+
+        //! Size and reader of a little-endian PLY scalar type.
+        struct PlyType
+        {
+            std::size_t Size{0};
+            double (*Load)(const char *){nullptr};
+        };
+
+        //! Get a PLY scalar type from its name, its size is 0 if it is unknown.
+        PlyType ply_type(const std::string &name)
+        {
+            static const std::map<std::string, PlyType> types{
+                {"char", {1, load<std::int8_t>}}, {"int8", {1, load<std::int8_t>}},
+                {"uchar", {1, load<std::uint8_t>}}, {"uint8", {1, load<std::uint8_t>}},
+                {"short", {2, load<std::int16_t>}}, {"int16", {2, load<std::int16_t>}},
+                {"ushort", {2, load<std::uint16_t>}}, {"uint16", {2, load<std::uint16_t>}},
+                {"int", {4, load<std::int32_t>}}, {"int32", {4, load<std::int32_t>}},
+                {"uint", {4, load<std::uint32_t>}}, {"uint32", {4, load<std::uint32_t>}},
+                {"float", {4, load<float>}}, {"float32", {4, load<float>}},
+                {"double", {8, load<double>}}, {"float64", {8, load<double>}}};
+            auto found = types.find(name);
+            return found == types.end() ? PlyType() : found->second;
+        }
+
+        //! Layout of a vertex record of a binary PLY file.
+        struct BinaryLayout
+        {
+            std::size_t Stride{0};
+            std::size_t Offsets[3]{0, 0, 0};
+            //! Type of x, y and z (no reader : z is 0).
+            PlyType Types[3];
+        };
+
+        //! Parse point_count points of the text [begin, end) of a file starting at file_begin, split at line starts into chunks parsed in parallel.
+        std::optional<std::vector<Point>> parse_text(const std::string &filename, const char *file_begin, const char *begin, const char *end, std::uint64_t point_count, const PointLayout &layout)
+        {
+            std::vector<const char *> chunks{begin};
+            for (const char *next = begin + TEXT_CHUNK_SIZE; next < end; next = chunks.back() + TEXT_CHUNK_SIZE)
+            {
+                next = std::find(next, end, '\n');
+                if (next == end)
+                    break;
+                chunks.push_back(next + 1);
+            }
+            chunks.push_back(end);
+            IndexType chunk_count = chunks.size() - 1;
+
+            std::vector<std::vector<Point>> parts(chunk_count);
+            std::vector<IndexType> error_lines(chunk_count, 0);
+            parallel_for(chunk_count, [&](IndexType chunk_begin, IndexType chunk_end)
+                         {
+                std::vector<float> values(layout.PropertyCount);
+                for (IndexType i_chunk = chunk_begin; i_chunk < chunk_end; ++i_chunk)
+                {
+                    TextReader reader(chunks[i_chunk], chunks[i_chunk + 1]);
+                    std::vector<Point> &part = parts[i_chunk];
+                    part.reserve((chunks[i_chunk + 1] - chunks[i_chunk]) / (8 * layout.PropertyCount));
+                    while (!reader.at_end())
+                    {
+                        for (float &value : values)
+                        {
+                            if (!reader.read(value))
+                            {
+                                error_lines[i_chunk] = reader.line();
+                                return;
+                            }
+                        }
+                        const int *c = layout.Coordinates;
+                        part.emplace_back(values[c[0]], values[c[1]], c[2] < 0 ? 0.f : values[c[2]]);
+                    }
+                } }, 1);
+
+            for (IndexType i_chunk = 0; i_chunk < chunk_count; ++i_chunk)
+            {
+                if (error_lines[i_chunk] != 0)
+                {
+                    IndexType line = std::count(file_begin, chunks[i_chunk], '\n') + error_lines[i_chunk];
+                    utils::error("in [read_points] Invalid point line ", line, ": ", filename);
+                    return std::nullopt;
+                }
+            }
+
+            std::vector<std::size_t> offsets(chunk_count + 1, 0);
+            for (IndexType i_chunk = 0; i_chunk < chunk_count; ++i_chunk)
+                offsets[i_chunk + 1] = offsets[i_chunk] + parts[i_chunk].size();
+            if (offsets.back() != point_count)
+            {
+                utils::error("in [read_points] ", point_count, " points expected, ", offsets.back(), " found: ", filename);
+                return std::nullopt;
+            }
+
+            std::vector<Point> points(point_count);
+            parallel_for(chunk_count, [&](IndexType chunk_begin, IndexType chunk_end)
+                         {
+                for (IndexType i_chunk = chunk_begin; i_chunk < chunk_end; ++i_chunk)
+                    std::copy(parts[i_chunk].begin(), parts[i_chunk].end(), points.begin() + offsets[i_chunk]); }, 1);
+            return points;
+        }
+
+        //! Decode point_count records of `stride` bytes, the coordinates are read by `decode(record, i_coordinate)`.
+        template <typename Decode>
+        std::optional<std::vector<Point>> parse_binary(const std::string &filename, const char *data, std::uint64_t point_count, std::size_t stride, const Decode &decode)
+        {
+            if (point_count > std::numeric_limits<IndexType>::max())
+            {
+                utils::error("in [read_points] Too many points (", point_count, "), at most ", std::numeric_limits<IndexType>::max(), " are supported: ", filename);
+                return std::nullopt;
+            }
+
+            std::vector<Point> points(point_count);
+            parallel_for(point_count, [&](IndexType begin, IndexType end)
+                         {
+                for (IndexType i = begin; i < end; ++i)
+                {
+                    const char *record = data + i * stride;
+                    points[i] = Point(decode(record, 0), decode(record, 1), decode(record, 2));
+                } });
+            return points;
+        }
+
+        std::optional<std::vector<Point>> read_text(const std::string &filename, const MappedFile &file)
+        {
+            TextReader reader(file.begin(), file.end());
+            std::uint64_t point_count;
+            if (!reader.read(point_count))
+            {
+                utils::error("in [read_points] Invalid header line ", reader.line(), ": ", filename);
+                return std::nullopt;
+            }
+            return parse_text(filename, file.begin(), reader.position(), file.end(), point_count, PointLayout());
+        }
+
+        template <typename T>
+        std::optional<std::vector<Point>> read_binary(const std::string &filename, const MappedFile &file)
+        {
+            if (file.size() % (3 * sizeof(T)) != 0)
+            {
+                utils::error("in [read_points] The size of the file is not a multiple of 3 ", sizeof(T) * 8, " bits numbers: ", filename);
+                return std::nullopt;
+            }
+            return parse_binary(filename, file.data(), file.size() / (3 * sizeof(T)), 3 * sizeof(T), [](const char *record, int i)
+                                { return load<T>(record + i * sizeof(T)); });
+        }
+
+        std::optional<std::vector<Point>> read_ply(const std::string &filename, const MappedFile &file)
+        {
+            const char *header_end = file.end();
+            static constexpr std::string_view end_header = "end_header";
+            const char *found = std::search(file.begin(), file.end(), end_header.begin(), end_header.end());
+            if (found != file.end())
+                header_end = std::find(found, file.end(), '\n');
+            if (!std::string_view(file.data(), file.size()).starts_with("ply") || header_end == file.end())
+            {
+                utils::error("in [read_points] Invalid PLY header: ", filename);
+                return std::nullopt;
+            }
+
+            std::istringstream header(std::string(file.begin(), header_end));
+            std::string format;
+            std::uint64_t point_count = 0;
+            bool vertex_element = false, first_element = true;
+            std::vector<std::pair<std::string, std::string>> properties;
+            for (std::string line; std::getline(header, line);)
+            {
+                std::istringstream words(line);
+                std::string keyword;
+                words >> keyword;
+                if (keyword == "format")
+                {
+                    words >> format;
+                }
+                else if (keyword == "element")
+                {
+                    std::string name;
+                    std::uint64_t count;
+                    words >> name >> count;
+                    vertex_element = name == "vertex";
+                    if (vertex_element && !first_element)
+                    {
+                        utils::error("in [read_points] The vertices must be the first element of the PLY file: ", filename);
+                        return std::nullopt;
+                    }
+                    if (vertex_element)
+                        point_count = count;
+                    first_element = false;
+                }
+                else if (keyword == "property" && vertex_element)
+                {
+                    std::string type, name;
+                    words >> type >> name;
+                    if (type == "list" || ply_type(type).Size == 0)
+                    {
+                        utils::error("in [read_points] Unsupported vertex property ", line, ": ", filename);
+                        return std::nullopt;
+                    }
+                    properties.emplace_back(type, name);
+                }
+            }
+
+            PointLayout layout;
+            layout.PropertyCount = properties.size();
+            BinaryLayout binary;
+            for (int i = 0; i < 3; ++i)
+            {
+                const std::string name(1, "xyz"[i]);
+                auto property = std::find_if(properties.begin(), properties.end(), [&](const auto &p)
+                                             { return p.second == name; });
+                layout.Coordinates[i] = property == properties.end() ? -1 : property - properties.begin();
+                if (property == properties.end())
+                    continue;
+                binary.Types[i] = ply_type(property->first);
+                for (auto p = properties.begin(); p != property; ++p)
+                    binary.Offsets[i] += ply_type(p->first).Size;
+            }
+            for (const auto &[type, name] : properties)
+                binary.Stride += ply_type(type).Size;
+
+            if (layout.Coordinates[0] < 0 || layout.Coordinates[1] < 0)
+            {
+                utils::error("in [read_points] The PLY vertices have no x or y property: ", filename);
+                return std::nullopt;
+            }
+
+            const char *body = header_end + 1;
+            if (format == "ascii")
+            {
+                // The vertices are the point_count first lines.
+                const char *end = body;
+                for (std::uint64_t i = 0; i < point_count && end != file.end(); ++i)
+                {
+                    end = std::find(end, file.end(), '\n');
+                    if (end != file.end())
+                        end++;
+                }
+                return parse_text(filename, file.begin(), body, end, point_count, layout);
+            }
+            if (format != "binary_little_endian")
+            {
+                utils::error("in [read_points] Unsupported PLY format ", format, ": ", filename);
+                return std::nullopt;
+            }
+            if (static_cast<std::uint64_t>(file.end() - body) / binary.Stride < point_count)
+            {
+                utils::error("in [read_points] The PLY file is truncated: ", filename);
+                return std::nullopt;
+            }
+            return parse_binary(filename, body, point_count, binary.Stride, [&](const char *record, int i)
+                                { return binary.Types[i].Load ? binary.Types[i].Load(record + binary.Offsets[i]) : 0.; });
+        }
+    } // namespace
+
+    bool is_point_cloud(const std::filesystem::path &file)
+    {
+        std::string extension = file.extension().string();
+        return extension == ".txt" || extension == ".xyzf" || extension == ".xyzd" || extension == ".ply";
+    }
+
+    std::optional<std::vector<Point>> read_points(const std::string &filename)
+    {
+        GAM_TRACE_SCOPE("read_points");
+        if (!is_point_cloud(filename))
+        {
+            utils::error("in [read_points] Unknown point cloud format: ", filename);
+            return std::nullopt;
+        }
+
+        MappedFile file(filename);
+        if (!file.is_open())
+        {
+            utils::error("in [read_points] Couldn't open this file: ", filename);
+            return std::nullopt;
+        }
+
+        std::string extension = std::filesystem::path(filename).extension().string();
+        if (extension == ".xyzf")
+            return read_binary<float>(filename, file);
+        if (extension == ".xyzd")
+            return read_binary<double>(filename, file);
+        if (extension == ".ply")
+            return read_ply(filename, file);
+        return read_text(filename, file);
+    }
+} // namespace gam
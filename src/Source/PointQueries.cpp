@@ -0,0 +1,89 @@
+#include "TMesh.h"
+#include "SpatialSort.h"
+#include "Instrumentation.h"
+
+namespace gam
+{
+    /*
+     * Batched point location. The queries are sorted along a Hilbert curve : consecutive queries are close, and the walk
+     * of a query starting from the face of the previous one only crosses a few faces. The sorted queries are split in
+     * contiguous chunks between the threads of the pool, the mesh is only read.
+     */
+
+    //! Barycentric weights of p in the face, or of its projection on the hull edge of an infinite face.
+    static PointLocation barycentric(const VertexArray &vertices, const Face &face, IndexType i_face, bool inside, const Point &p)
+    {
+        PointLocation location{i_face, {}, inside};
+        if (!inside)
+        {
+            // The infinite vertex is the first one.
+            Point u = vertices.point(face[1]);
+            Point v = vertices.point(face[2]);
+            double ex = static_cast<double>(v.x) - u.x, ey = static_cast<double>(v.y) - u.y;
+            double length2 = ex * ex + ey * ey;
+            double t = length2 > 0. ? ((static_cast<double>(p.x) - u.x) * ex + (static_cast<double>(p.y) - u.y) * ey) / length2 : 0.;
+            t = std::clamp(t, 0., 1.);
+            location.Weights = {0.f, static_cast<ScalarType>(1. - t), static_cast<ScalarType>(t)};
+            return location;
+        }
+
+        auto area = [](const Point &a, const Point &b, const Point &c)
+        { return (static_cast<double>(b.x) - a.x) * (static_cast<double>(c.y) - a.y) - (static_cast<double>(b.y) - a.y) * (static_cast<double>(c.x) - a.x); };
+        Point a = vertices.point(face[0]);
+        Point b = vertices.point(face[1]);
+        Point c = vertices.point(face[2]);
+        double total = area(a, b, c);
+        double wa = area(p, b, c) / total;
+        double wb = area(a, p, c) / total;
+        location.Weights = {static_cast<ScalarType>(wa), static_cast<ScalarType>(wb), static_cast<ScalarType>(1. - wa - wb)};
+        return location;
+    }
+
+    void TMesh::locate_points(std::span<const Point> queries, std::span<PointLocation> locations) const
+    {
+        assert(locations.size() >= queries.size());
+        assert(face_count() > 0);
+        if (queries.empty())
+            return;
+        GAM_TRACE_SCOPE("locate_points");
+
+        std::vector<IndexType> order(queries.size());
+        std::iota(order.begin(), order.end(), IndexType(0));
+        hilbert_sort(queries, order.begin(), order.end());
+
+        parallel_for(order.size(), [&](IndexType begin, IndexType end)
+                     {
+            // The first walk of the chunk descends the hierarchy if there is one, and starts from the last inserted vertex otherwise.
+            std::uint64_t steps = 0;
+            IndexType i_face = hierarchy_start_face(queries[order[begin]], 0, steps);
+            for (IndexType k = begin; k < end; ++k)
+            {
+                const Point &p = queries[order[k]];
+                auto [inside, location] = locate_triangle(p, i_face, steps);
+                i_face = location.first;
+                locations[order[k]] = barycentric(m_vertices, m_faces[i_face], i_face, inside, p);
+            } });
+    }
+
+    void TMesh::interpolate_values(std::span<const PointLocation> locations, std::span<ScalarType> values) const
+    {
+        assert(values.size() >= locations.size());
+        assert(m_values.size() == vertex_count());
+
+        parallel_for(locations.size(), [&](IndexType begin, IndexType end)
+                     {
+            for (IndexType i = begin; i < end; ++i)
+            {
+                const PointLocation &location = locations[i];
+                const Face &face = m_faces[location.Face];
+                ScalarType value = 0;
+                for (IndexType j = 0; j < 3; ++j)
+                {
+                    // The value of the infinite vertex is not used.
+                    if (face[j] != 0)
+                        value += location.Weights[j] * m_values[face[j]];
+                }
+                values[i] = value;
+            } });
+    }
+} // namespace gam
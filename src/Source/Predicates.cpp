@@ -0,0 +1,158 @@
+#include "Predicates.h"
+
+namespace gam
+{
+    // Exact evaluation with floating-point expansions (sums of non-overlapping doubles), see J. R. Shewchuk,
+    // "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates" (1997).
+
+    static std::atomic<std::uint64_t> s_orientation_exact{0};
+    static std::atomic<std::uint64_t> s_in_circle_exact{0};
+
+    //! Sum of non-overlapping doubles, ordered by increasing magnitude.
+    using Expansion = std::vector<double>;
+
+    //! a + b = x + y exactly.
+    static inline void two_sum(double a, double b, double &x, double &y)
+    {
+        x = a + b;
+        double bv = x - a;
+        double av = x - bv;
+        y = (a - av) + (b - bv);
+    }
+
+    //! a * b = x + y exactly.
+    static inline void two_product(double a, double b, double &x, double &y)
+    {
+        x = a * b;
+        y = std::fma(a, b, -x);
+    }
+
+    //! Exact difference of two doubles.
+    static Expansion difference(double a, double b)
+    {
+        double x, y;
+        two_sum(a, -b, x, y);
+        if (y == 0.)
+            return {x};
+        return {y, x};
+    }
+
+    //! Sum of an expansion and a double (grow_expansion_zeroelim).
+    static Expansion grow(const Expansion &e, double b)
+    {
+        Expansion h;
+        h.reserve(e.size() + 1);
+        double q = b;
+        for (double ei : e)
+        {
+            double sum, err;
+            two_sum(q, ei, sum, err);
+            if (err != 0.)
+                h.push_back(err);
+            q = sum;
+        }
+        if (q != 0. || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    //! Sum of two expansions (expansion_sum_zeroelim).
+    static Expansion sum(Expansion e, const Expansion &f)
+    {
+        for (double fi : f)
+            e = grow(e, fi);
+        return e;
+    }
+
+    static Expansion negate(Expansion e)
+    {
+        for (double &ei : e)
+            ei = -ei;
+        return e;
+    }
+
+    //! Product of an expansion and a double (scale_expansion_zeroelim).
+    static Expansion scale(const Expansion &e, double b)
+    {
+        Expansion h;
+        h.reserve(2 * e.size());
+        double q, hh;
+        two_product(e[0], b, q, hh);
+        if (hh != 0.)
+            h.push_back(hh);
+        for (std::size_t i = 1; i < e.size(); ++i)
+        {
+            double product1, product0, sum;
+            two_product(e[i], b, product1, product0);
+            two_sum(q, product0, sum, hh);
+            if (hh != 0.)
+                h.push_back(hh);
+            two_sum(product1, sum, q, hh);
+            if (hh != 0.)
+                h.push_back(hh);
+        }
+        if (q != 0. || h.empty())
+            h.push_back(q);
+        return h;
+    }
+
+    //! Product of two expansions.
+    static Expansion product(const Expansion &e, const Expansion &f)
+    {
+        Expansion h = scale(e, f[0]);
+        for (std::size_t i = 1; i < f.size(); ++i)
+            h = sum(h, scale(e, f[i]));
+        return h;
+    }
+
+    //! The most significant component of an expansion has the sign of the expansion.
+    static inline double sign_of(const Expansion &e)
+    {
+        return e.back();
+    }
+
+    double orient2d_exact(double ax, double ay, double bx, double by, double cx, double cy)
+    {
+        s_orientation_exact.fetch_add(1, std::memory_order_relaxed);
+
+        Expansion acx = difference(ax, cx);
+        Expansion acy = difference(ay, cy);
+        Expansion bcx = difference(bx, cx);
+        Expansion bcy = difference(by, cy);
+
+        return sign_of(sum(product(acx, bcy), negate(product(acy, bcx))));
+    }
+
+    double incircle_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+    {
+        s_in_circle_exact.fetch_add(1, std::memory_order_relaxed);
+
+        Expansion adx = difference(ax, dx);
+        Expansion ady = difference(ay, dy);
+        Expansion bdx = difference(bx, dx);
+        Expansion bdy = difference(by, dy);
+        Expansion cdx = difference(cx, dx);
+        Expansion cdy = difference(cy, dy);
+
+        Expansion alift = sum(product(adx, adx), product(ady, ady));
+        Expansion blift = sum(product(bdx, bdx), product(bdy, bdy));
+        Expansion clift = sum(product(cdx, cdx), product(cdy, cdy));
+
+        Expansion bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+        Expansion ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+        Expansion ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+        return sign_of(sum(sum(product(alift, bc), product(blift, ca)), product(clift, ab)));
+    }
+
+    PredicateStats predicate_stats()
+    {
+        return {s_orientation_exact.load(std::memory_order_relaxed), s_in_circle_exact.load(std::memory_order_relaxed)};
+    }
+
+    void reset_predicate_stats()
+    {
+        s_orientation_exact.store(0, std::memory_order_relaxed);
+        s_in_circle_exact.store(0, std::memory_order_relaxed);
+    }
+} // namespace gam
@@ -0,0 +1,101 @@
+#include "SparseMatrix.h"
+
+namespace gam
+{
+    int SparseMatrix::find(IndexType i, IndexType j) const
+    {
+        assert(i < rows());
+
+        for (IndexType k = RowStart[i]; k < RowStart[i + 1]; ++k)
+        {
+            if (Columns[k] == j)
+                return k;
+        }
+        return -1;
+    }
+
+    std::vector<double> SparseMatrix::diagonal() const
+    {
+        std::vector<double> diagonal(rows(), 0.);
+        for (IndexType i = 0; i < rows(); ++i)
+        {
+            int k = find(i, i);
+            if (k != -1)
+                diagonal[i] = Values[k];
+        }
+        return diagonal;
+    }
+
+    void SparseMatrix::clear()
+    {
+        RowStart.clear();
+        Columns.clear();
+        Values.clear();
+    }
+
+    //! Sequential, so that the result does not depend on the number of threads.
+    static double dot_product(const std::vector<double> &u, const std::vector<double> &v)
+    {
+        double sum = 0.;
+        for (IndexType i = 0; i < u.size(); ++i)
+            sum += u[i] * v[i];
+        return sum;
+    }
+
+    SolverStats conjugate_gradient(const SparseMatrix &A, const std::vector<double> &b, std::vector<double> &x, IndexType max_iterations, double tolerance)
+    {
+        assert(b.size() == A.rows());
+
+        SolverStats stats;
+        IndexType n = A.rows();
+        x.resize(n, 0.);
+
+        // Jacobi preconditioner : z = D^-1 r.
+        std::vector<double> inverse_diagonal = A.diagonal();
+        for (auto &d : inverse_diagonal)
+            d = d > 0. ? 1. / d : 1.;
+
+        std::vector<double> r(n), z(n), p(n), Ap(n);
+        A.multiply(x, Ap);
+        for (IndexType i = 0; i < n; ++i)
+        {
+            r[i] = b[i] - Ap[i];
+            z[i] = inverse_diagonal[i] * r[i];
+        }
+        p = z;
+
+        double b_norm = std::sqrt(dot_product(b, b));
+        if (b_norm == 0.)
+            b_norm = 1.;
+
+        double rz = dot_product(r, z);
+        stats.Residual = std::sqrt(dot_product(r, r)) / b_norm;
+        while (stats.Residual > tolerance && stats.Iterations < max_iterations)
+        {
+            A.multiply(p, Ap);
+            double alpha = rz / dot_product(p, Ap);
+            parallel_for(n, [&](IndexType begin, IndexType end)
+                         {
+                for (IndexType i = begin; i < end; ++i)
+                {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * Ap[i];
+                    z[i] = inverse_diagonal[i] * r[i];
+                } });
+
+            double rz_next = dot_product(r, z);
+            double beta = rz_next / rz;
+            rz = rz_next;
+            parallel_for(n, [&](IndexType begin, IndexType end)
+                         {
+                for (IndexType i = begin; i < end; ++i)
+                    p[i] = z[i] + beta * p[i]; });
+
+            stats.Iterations++;
+            stats.Residual = std::sqrt(dot_product(r, r)) / b_norm;
+        }
+
+        stats.Converged = stats.Residual <= tolerance;
+        return stats;
+    }
+} // namespace gam
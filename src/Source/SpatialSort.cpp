@@ -0,0 +1,106 @@
+#include "SpatialSort.h"
+
+namespace gam
+{
+    //! Number of bits per axis used to quantize the coordinates on the Hilbert grid.
+    constexpr int HILBERT_ORDER = 16;
+
+    //! Below this size, a BRIO round is not split anymore.
+    constexpr std::ptrdiff_t BRIO_THRESHOLD = 64;
+
+    std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y, int order)
+    {
+        std::uint64_t d = 0;
+        for (std::uint32_t s = 1u << (order - 1); s > 0; s >>= 1)
+        {
+            std::uint32_t rx = (x & s) > 0;
+            std::uint32_t ry = (y & s) > 0;
+            d += static_cast<std::uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+            // Rotate the quadrant so that the curve stays continuous.
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = s - 1 - (x & (s - 1));
+                    y = s - 1 - (y & (s - 1));
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    HilbertGrid hilbert_grid(std::span<const Point> points)
+    {
+        ScalarType xmin = std::numeric_limits<ScalarType>::max(), ymin = xmin;
+        ScalarType xmax = std::numeric_limits<ScalarType>::lowest(), ymax = xmax;
+        for (const auto &p : points)
+        {
+            xmin = std::min(xmin, p.x);
+            ymin = std::min(ymin, p.y);
+            xmax = std::max(xmax, p.x);
+            ymax = std::max(ymax, p.y);
+        }
+
+        const double cells = static_cast<double>((1u << HILBERT_ORDER) - 1);
+        const double extent = std::max(static_cast<double>(xmax) - xmin, static_cast<double>(ymax) - ymin);
+        return {xmin, ymin, extent > 0. ? cells / extent : 0.};
+    }
+
+    void hilbert_sort(std::span<const Point> points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end)
+    {
+        if (end - begin < 2)
+            return;
+        hilbert_sort(points, begin, end, hilbert_grid(points));
+    }
+
+    void hilbert_sort(std::span<const Point> points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end, const HilbertGrid &grid)
+    {
+        if (end - begin < 2)
+            return;
+
+        std::vector<std::pair<std::uint64_t, IndexType>> keys;
+        keys.reserve(end - begin);
+        for (auto it = begin; it != end; ++it)
+        {
+            const Point &p = points[*it];
+            auto x = static_cast<std::uint32_t>((p.x - grid.XMin) * grid.Scale);
+            auto y = static_cast<std::uint32_t>((p.y - grid.YMin) * grid.Scale);
+            keys.emplace_back(hilbert_index(x, y, HILBERT_ORDER), *it);
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        for (const auto &[key, index] : keys)
+            *begin++ = index;
+    }
+
+    //! Recursively sort the last half of [begin, end) and split the first half again, so that each round is twice as large as the previous one.
+    static void brio_rounds(const std::vector<Point> &points, std::vector<IndexType>::iterator begin, std::vector<IndexType>::iterator end, const HilbertGrid &grid)
+    {
+        auto middle = begin;
+        if (end - begin > BRIO_THRESHOLD)
+        {
+            middle = begin + (end - begin) / 2;
+            brio_rounds(points, begin, middle, grid);
+        }
+        hilbert_sort(points, middle, end, grid);
+    }
+
+    std::vector<IndexType> brio_order(const std::vector<Point> &points, IndexType point_count, unsigned seed)
+    {
+        assert(point_count <= points.size());
+
+        std::vector<IndexType> order(point_count);
+        std::iota(order.begin(), order.end(), IndexType(0));
+
+        std::default_random_engine rng(seed);
+        std::shuffle(order.begin(), order.end(), rng);
+
+        // The rounds share the grid of all the points : its bounding box is computed once.
+        brio_rounds(points, order.begin(), order.end(), hilbert_grid(points));
+
+        return order;
+    }
+} // namespace gam
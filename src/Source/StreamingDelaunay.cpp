@@ -0,0 +1,402 @@
+#include "StreamingDelaunay.h"
+
+#include "Geometry.h"
+#include "Instrumentation.h"
+#include "MappedFile.h"
+
+namespace gam
+{
+    /*
+     * Out-of-core construction of the Delaunay triangulation.
+     *
+     * The points are bucketed into vertical strips [x_k, x_k+1[ of about ChunkSize points, the strips are read from
+     * left to right. The active points are the points of the current strip and the vertices kept from the previous
+     * strips. A triangle of their triangulation whose circumcircle lies left of the next strips cannot contain a
+     * future point : it is final and written. A vertex whose faces are all final is dropped, as in the parallel
+     * construction the triangulation of the remaining vertices then has triangles over the written ones (holes of
+     * the dropped vertices, or triangles written before) : each kept vertex remembers the corners of its written
+     * triangles and a triangle whose centroid falls in such a corner is skipped.
+     * Hull vertices are always kept : a future point may connect to any of them.
+     */
+
+    //! Points read or written at a time in the temporary files.
+    constexpr std::size_t STREAMING_BLOCK_SIZE = 1 << 16;
+
+    //! Resolution of the histogram of the abscissas used to place the strips.
+    constexpr std::size_t STREAMING_BIN_COUNT = 1 << 16;
+
+    namespace
+    {
+        //! Vertex kept from a strip to the next one.
+        struct FrontVertex
+        {
+            std::uint64_t Id;
+            Point Position;
+            //! The two other vertices of each written triangle of the vertex, counterclockwise.
+            std::vector<std::array<Point, 2>> Corners;
+        };
+
+        //! Removes the temporary files.
+        struct TemporaryDirectory
+        {
+            std::filesystem::path Path;
+
+            ~TemporaryDirectory()
+            {
+                std::error_code error;
+                std::filesystem::remove_all(Path, error);
+            }
+        };
+
+        //! Sequential reader of the points of a temporary file.
+        class PointReader
+        {
+        public:
+            explicit PointReader(const std::filesystem::path &path) : m_file(path, std::ios::binary) {}
+
+            //! Read the next block of points, returns false at the end of the file.
+            bool next(std::vector<Point> &points)
+            {
+                points.resize(STREAMING_BLOCK_SIZE);
+                m_file.read(reinterpret_cast<char *>(points.data()), points.size() * sizeof(Point));
+                points.resize(m_file.gcount() / sizeof(Point));
+                return !points.empty();
+            }
+
+        private:
+            std::ifstream m_file;
+        };
+
+        void write_points(const std::filesystem::path &path, const std::vector<Point> &points)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            file.write(reinterpret_cast<const char *>(points.data()), points.size() * sizeof(Point));
+        }
+
+        //! Returns true if the circumcircle of (a, b, c) lies strictly left of x, with a safety margin for the rounding errors.
+        bool left_of(const Point &a, const Point &b, const Point &c, double x)
+        {
+            double cx, cy, r;
+            if (!circumcircle(a, b, c, cx, cy, r))
+                return false;
+
+            double margin = r + 1e-6 * (std::abs(cx) + std::abs(cy) + r);
+            return cx + margin < x;
+        }
+
+        //! Returns true if g lies in one of the corners of the written triangles of the vertex.
+        bool in_corners(const FrontVertex &vertex, const Point &g)
+        {
+            for (const auto &[p, q] : vertex.Corners)
+            {
+                if (orientation(vertex.Position, p, g) >= 0 && orientation(vertex.Position, g, q) >= 0)
+                    return true;
+            }
+            return false;
+        }
+    } // namespace
+
+    std::optional<StreamingStats> triangulate_streaming(const std::string &cloud_file, const std::string &output_file, const StreamingOptions &options, const ProgressCallback &progress)
+    {
+        GAM_TRACE_SCOPE("triangulate_streaming");
+
+        std::string extension = std::filesystem::path(output_file).extension().string();
+        if (extension != ".obj" && extension != ".off")
+        {
+            utils::error("in [triangulate_streaming] The output must be an .obj or .off file: ", output_file);
+            return std::nullopt;
+        }
+        bool off = extension == ".off";
+        std::filesystem::path output_path = (off ? utils::data_directories().Off : utils::data_directories().Obj) + output_file;
+
+        std::error_code error;
+        std::filesystem::path temporary_root = options.TemporaryDirectory.empty() ? std::filesystem::temp_directory_path(error) : options.TemporaryDirectory;
+        TemporaryDirectory temporary{temporary_root / ("gam_streaming_" + std::to_string(std::random_device()()))};
+        if (error || !std::filesystem::create_directories(temporary.Path, error))
+        {
+            utils::error("in [triangulate_streaming] Couldn't create the temporary directory: ", temporary.Path.string());
+            return std::nullopt;
+        }
+
+        StreamingStats stats;
+
+        // Copy of the cloud as binary points, and bounding box of the abscissas.
+        float x_min = std::numeric_limits<float>::max();
+        float x_max = std::numeric_limits<float>::lowest();
+        std::filesystem::path all_path = temporary.Path / "points.bin";
+        {
+            GAM_TRACE_SCOPE("read_cloud");
+            MappedFile file(utils::data_directories().Cloud + cloud_file);
+            if (!file.is_open())
+            {
+                utils::error("in [triangulate_streaming] Couldn't open this file: ", cloud_file);
+                return std::nullopt;
+            }
+            TextReader reader(file.begin(), file.end());
+            std::uint64_t point_count;
+            if (!reader.read(point_count))
+            {
+                utils::error("in [triangulate_streaming] Invalid header line ", reader.line(), ": ", cloud_file);
+                return std::nullopt;
+            }
+
+            std::ofstream all(all_path, std::ios::binary);
+            std::vector<Point> block;
+            block.reserve(STREAMING_BLOCK_SIZE);
+            for (std::uint64_t i = 0; i < point_count; ++i)
+            {
+                float x, y, z;
+                if (!reader.read(x) || !reader.read(y) || !reader.read(z))
+                {
+                    utils::error("in [triangulate_streaming] Invalid point line ", reader.line(), ": ", cloud_file);
+                    return std::nullopt;
+                }
+                x_min = std::min(x_min, x);
+                x_max = std::max(x_max, x);
+                block.emplace_back(x, y, z);
+                if (block.size() == STREAMING_BLOCK_SIZE)
+                {
+                    all.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(Point));
+                    block.clear();
+                }
+            }
+            all.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(Point));
+            if (!all)
+            {
+                utils::error("in [triangulate_streaming] Couldn't write the temporary file: ", all_path.string());
+                return std::nullopt;
+            }
+            stats.PointCount = point_count;
+        }
+
+        if (stats.PointCount < 3)
+        {
+            utils::error("in [triangulate_streaming] At least 3 points are needed: ", cloud_file);
+            return std::nullopt;
+        }
+
+        // The strips are runs of histogram bins of about ChunkSize points.
+        double bin_width = std::max<double>(x_max - x_min, 1e-30) / STREAMING_BIN_COUNT;
+        auto bin = [&](float x)
+        { return std::min<std::size_t>(static_cast<std::size_t>((x - x_min) / bin_width), STREAMING_BIN_COUNT - 1); };
+
+        std::vector<std::uint64_t> histogram(STREAMING_BIN_COUNT, 0);
+        std::vector<Point> block;
+        for (PointReader reader(all_path); reader.next(block);)
+        {
+            for (const Point &p : block)
+                histogram[bin(p.x)]++;
+        }
+
+        std::vector<IndexType> bin_strip(STREAMING_BIN_COUNT);
+        std::uint64_t strip_size = 0;
+        IndexType strip_count = 1;
+        for (std::size_t i = 0; i < STREAMING_BIN_COUNT; ++i)
+        {
+            if (strip_size >= options.ChunkSize && histogram[i] > 0)
+            {
+                strip_count++;
+                strip_size = 0;
+            }
+            bin_strip[i] = strip_count - 1;
+            strip_size += histogram[i];
+        }
+        stats.ChunkCount = strip_count;
+
+        // Bucket the points, the strips keep the order of the file.
+        auto strip_path = [&](IndexType i_strip)
+        { return temporary.Path / ("strip_" + std::to_string(i_strip) + ".bin"); };
+
+        std::vector<std::uint64_t> strip_sizes(strip_count, 0);
+        std::vector<float> strip_min(strip_count, std::numeric_limits<float>::max());
+        {
+            GAM_TRACE_SCOPE("bucket_points");
+            std::vector<std::vector<Point>> buffers(strip_count);
+            for (PointReader reader(all_path); reader.next(block);)
+            {
+                for (const Point &p : block)
+                {
+                    IndexType i_strip = bin_strip[bin(p.x)];
+                    strip_sizes[i_strip]++;
+                    strip_min[i_strip] = std::min(strip_min[i_strip], p.x);
+                    buffers[i_strip].push_back(p);
+                    if (buffers[i_strip].size() == STREAMING_BLOCK_SIZE)
+                    {
+                        write_points(strip_path(i_strip), buffers[i_strip]);
+                        buffers[i_strip].clear();
+                    }
+                }
+            }
+            for (IndexType i_strip = 0; i_strip < strip_count; ++i_strip)
+                write_points(strip_path(i_strip), buffers[i_strip]);
+        }
+        std::filesystem::remove(all_path, error);
+
+        // A triangle is final once its circumcircle lies left of every point of the next strips.
+        std::vector<double> next_min(strip_count + 1, std::numeric_limits<double>::infinity());
+        for (IndexType i_strip = strip_count; i_strip-- > 0;)
+            next_min[i_strip] = std::min<double>(next_min[i_strip + 1], strip_min[i_strip]);
+
+        // The vertices are numbered strip by strip. The .obj vertices are written with their strip, the .off vertices and faces are gathered after the header, once the face count is known.
+        std::ofstream output(off ? temporary.Path / "faces.txt" : output_path);
+        std::ofstream vertices;
+        if (off)
+            vertices.open(temporary.Path / "vertices.txt");
+        if (!output.is_open() || (off && !vertices.is_open()))
+        {
+            utils::error("in [triangulate_streaming] Couldn't create this file: ", output_path.string());
+            return std::nullopt;
+        }
+        if (!off)
+            output << "# " << stats.PointCount << " vertices, streaming Delaunay triangulation of " << cloud_file << "\n";
+
+        std::vector<FrontVertex> front;
+        std::uint64_t first_id = 0;
+        for (IndexType i_strip = 0; i_strip < strip_count; ++i_strip)
+        {
+            GAM_TRACE_SCOPE("triangulate_strip");
+            if (progress && !progress(static_cast<float>(first_id) / stats.PointCount))
+                return std::nullopt;
+
+            std::vector<FrontVertex> active = std::move(front);
+            front.clear();
+
+            std::vector<Point> strip;
+            strip.reserve(strip_sizes[i_strip]);
+            for (PointReader reader(strip_path(i_strip)); reader.next(block);)
+                strip.insert(strip.end(), block.begin(), block.end());
+            std::filesystem::remove(strip_path(i_strip), error);
+
+            for (const Point &p : strip)
+            {
+                if (off)
+                    vertices << p.x << " " << p.y << " " << p.z << "\n";
+                else
+                    output << "v " << p.x << " " << p.y << " " << p.z << "\n";
+            }
+
+            // The points of the strip are after the front, the duplicates are dropped : they can only be in the same strip.
+            std::vector<IndexType> order(strip.size());
+            std::iota(order.begin(), order.end(), IndexType(0));
+            std::sort(order.begin(), order.end(), [&](IndexType i, IndexType j)
+                      { return std::tie(strip[i].x, strip[i].y, i) < std::tie(strip[j].x, strip[j].y, j); });
+            for (IndexType k = 0; k < order.size(); ++k)
+            {
+                const Point &p = strip[order[k]];
+                if (k > 0 && p.x == strip[order[k - 1]].x && p.y == strip[order[k - 1]].y)
+                {
+                    stats.DuplicateCount++;
+                    continue;
+                }
+                active.push_back({first_id + order[k], p, {}});
+            }
+            first_id += strip.size();
+            strip = std::vector<Point>();
+
+            std::vector<Point> points;
+            points.reserve(active.size());
+            for (const auto &vertex : active)
+                points.emplace_back(vertex.Position.x, vertex.Position.y, 0.f);
+            stats.MaxActivePoints = std::max<IndexType>(stats.MaxActivePoints, points.size());
+
+            // The first face of the triangulation must not be degenerated : the points wait for the next strip.
+            bool degenerated = true;
+            for (IndexType i = 2; i < points.size() && degenerated; ++i)
+                degenerated = orientation(points[0], points[1], points[i]) == 0;
+            if (degenerated)
+            {
+                front = std::move(active);
+                continue;
+            }
+
+            TMesh mesh;
+            mesh.insertion_engine(options.Engine);
+            mesh.insert_vertices(points, -1, true);
+            std::vector<IndexType> vertex_point(mesh.vertex_count(), 0);
+            for (IndexType i = 0; i < points.size(); ++i)
+                vertex_point[mesh.point_vertex_indices()[i]] = i;
+
+            double limit = next_min[i_strip + 1];
+            std::vector<bool> kept(active.size(), false);
+            std::vector<std::vector<std::array<Point, 2>>> written(active.size());
+            for (IndexType i_face = 0; i_face < mesh.face_count(); ++i_face)
+            {
+                const Face &face = mesh.faces()[i_face];
+                if (mesh.is_infinite_face(i_face))
+                {
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        if (face[i] != 0)
+                            kept[vertex_point[face[i]]] = true;
+                    }
+                    continue;
+                }
+
+                IndexType v[3] = {vertex_point[face[0]], vertex_point[face[1]], vertex_point[face[2]]};
+                const Point &a = points[v[0]];
+                const Point &b = points[v[1]];
+                const Point &c = points[v[2]];
+                Point g((a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3, 0.f);
+                if (in_corners(active[v[0]], g) || in_corners(active[v[1]], g) || in_corners(active[v[2]], g))
+                    continue;
+
+                if (!left_of(a, b, c, limit))
+                {
+                    for (IndexType i : v)
+                        kept[i] = true;
+                    continue;
+                }
+
+                // The .obj indices start at 1.
+                std::uint64_t base = off ? 0 : 1;
+                output << (off ? "3 " : "f ") << active[v[0]].Id + base << " " << active[v[1]].Id + base << " " << active[v[2]].Id + base << "\n";
+                stats.TriangleCount++;
+
+                written[v[0]].push_back({b, c});
+                written[v[1]].push_back({c, a});
+                written[v[2]].push_back({a, b});
+            }
+
+            for (IndexType i = 0; i < active.size(); ++i)
+            {
+                if (!kept[i])
+                    continue;
+                FrontVertex &vertex = front.emplace_back(std::move(active[i]));
+                vertex.Corners.insert(vertex.Corners.end(), written[i].begin(), written[i].end());
+            }
+        }
+
+        if (!output || (off && !vertices))
+        {
+            utils::error("in [triangulate_streaming] Couldn't write this file: ", output_path.string());
+            return std::nullopt;
+        }
+        output.close();
+        vertices.close();
+
+        // .off : header, vertices, then faces.
+        if (off)
+        {
+            std::ofstream file(output_path);
+            if (!file.is_open())
+            {
+                utils::error("in [triangulate_streaming] Couldn't create this file: ", output_path.string());
+                return std::nullopt;
+            }
+            file << "OFF\n" << stats.PointCount << " " << stats.TriangleCount << " 0\n";
+            std::ifstream vertex_lines(temporary.Path / "vertices.txt");
+            std::ifstream face_lines(temporary.Path / "faces.txt");
+            file << vertex_lines.rdbuf() << face_lines.rdbuf();
+            if (!file)
+            {
+                utils::error("in [triangulate_streaming] Couldn't write this file: ", output_path.string());
+                return std::nullopt;
+            }
+        }
+
+        if (progress)
+            progress(1.f);
+        utils::status("File ", output_file, " successfully saved : ", stats.TriangleCount, " triangles, ", stats.ChunkCount, " strips");
+        return stats;
+    }
+} // namespace gam
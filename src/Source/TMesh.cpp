@@ -1,43 +1,159 @@
 #include "TMesh.h"
 
+#include "SpatialSort.h"
+#include "MappedFile.h"
+#include "Instrumentation.h"
+
 namespace gam
 {
+    //! Number of insertions between two calls to the progress callback.
+    constexpr int PROGRESS_INTERVAL = 4096;
+
+    //! A vertex of a level of the Delaunay hierarchy is also in the level above with a probability 1 / HIERARCHY_RATIO, up to HIERARCHY_MAX_LEVELS levels above the mesh.
+    constexpr std::uint64_t HIERARCHY_RATIO = 30;
+    constexpr IndexType HIERARCHY_MAX_LEVELS = 5;
+
+    //! Point index of the vertices that were not created by `insert_vertices`.
+    constexpr IndexType NO_POINT = std::numeric_limits<IndexType>::max();
+
+    //! Draw of the promotion of a vertex to the level above : a hash of its index, so that a vertex reinserted in its slot keeps its levels.
+    static bool promoted(IndexType level, IndexType i_vertex)
+    {
+        std::uint64_t h = (static_cast<std::uint64_t>(level) << 32 | i_vertex) + 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        h ^= h >> 31;
+        return h % HIERARCHY_RATIO == 0;
+    }
+
+    //! Edge (A, B) of the border of a cavity, counterclockwise around the cavity : Inside is the removed face of the edge, Outside the kept one.
+    struct CavityEdge
+    {
+        IndexType A, B;
+        IndexType Inside, Outside;
+    };
+
+    //! Buffers of the insertion and of the removal, one per thread (the parallel construction inserts on several threads) : their capacity is kept from one insertion to the next.
+    struct InsertionScratch
+    {
+        //! Faces to check by lawson.
+        std::vector<IndexType> FlipStack;
+        //! Faces around the infinite vertex, for insert_outside.
+        std::vector<IndexType> HullFaces;
+
+        //! Faces of the cavity of insert_cavity, and edges of its border.
+        std::vector<IndexType> Cavity;
+        std::vector<CavityEdge> Border;
+        //! First vertex and index of each edge of the border, sorted.
+        std::vector<std::pair<IndexType, IndexType>> BorderStarts;
+
+        //! Hole of remove_vertex : its faces and vertices, the polygon left by the ears and the ears cut.
+        std::vector<IndexType> HoleFaces;
+        std::vector<IndexType> HoleVertices;
+        std::vector<IndexType> EdgeFaces;
+        std::vector<IndexType> Next, Previous;
+        std::vector<std::pair<double, IndexType>> Ears;
+        std::vector<std::array<IndexType, 3>> Cuts;
+
+        //! Moves of move_vertices along the Hilbert curve, and the edges to legalize after them.
+        std::vector<IndexType> MoveOrder;
+        std::vector<std::pair<IndexType, IndexType>> MovedEdges;
+    };
+
+    static InsertionScratch &insertion_scratch()
+    {
+        static thread_local InsertionScratch scratch;
+        return scratch;
+    }
 
     /************************* Triangulated Mesh **************************/
 
+#ifndef GAM_HEADLESS
     Mesh TMesh::mesh(bool curvature, bool remove_infinite) const
     {
-        Mesh mesh(GL_TRIANGLES);
+        // The attributes are built as whole arrays and handed to the mesh at once.
+        std::vector<vec3> positions(vertex_count());
+        export_positions(positions);
+
+        const auto &scalars = curvature && !m_curvature.empty() ? m_curvature : m_values;
+        std::vector<vec2> texcoords(scalars.size());
+        for (IndexType i = 0; i < scalars.size(); ++i)
+            texcoords[i] = vec2(scalars[i], scalars[i]);
+
+        std::vector<vec3> normals(m_normals.begin(), m_normals.end());
+
+        Color red = Red(), white = White();
+        std::vector<vec4> colors(vertex_count(), vec4(red.r, red.g, red.b, red.a));
+        if (!colors.empty())
+            colors[0] = vec4(white.r, white.g, white.b, white.a);
+
+        std::vector<unsigned> indices(3 * face_count());
+        indices.resize(3 * export_triangles(indices, remove_infinite));
 
-        for (int i = 0; i < vertex_count(); ++i)
+        return Mesh(GL_TRIANGLES, positions, texcoords, normals, colors, indices);
+    }
+#endif
+
+    void TMesh::export_positions(std::span<vec3> positions) const
+    {
+        assert(positions.size() == vertex_count());
+
+        for (IndexType i = 0; i < vertex_count(); ++i)
+            positions[i] = vec3(m_vertices.X[i], m_vertices.Y[i], m_vertices.Z[i]);
+    }
+
+    IndexType TMesh::export_triangles(std::span<std::uint32_t> indices, bool remove_infinite, bool keep_slots) const
+    {
+        assert(indices.size() == 3 * face_count());
+
+        IndexType count = 0;
+        for (IndexType i = 0; i < face_count(); ++i)
         {
-            if (i == 0)
-                mesh.color(White());
-            else
-                mesh.color(Red());
-            if (m_normals.size() > 0)
-            {
-                mesh.normal(m_normals[i]);
-            }
-            if (curvature && m_curvature.size() > 0)
-            {
-                mesh.texcoord({m_curvature[i], m_curvature[i]});
-            }
-            else if (m_values.size() > 0)
+            if (is_free_face(i) || (remove_infinite && is_infinite_face(i)))
             {
-                mesh.texcoord({m_values[i], m_values[i]});
+                if (keep_slots)
+                    indices[3 * i] = indices[3 * i + 1] = indices[3 * i + 2] = 0;
+                continue;
             }
-            mesh.vertex(Vertex::as_point(m_vertices[i]));
+
+            IndexType slot = keep_slots ? i : count;
+            for (int k = 0; k < 3; ++k)
+                indices[3 * slot + k] = m_faces[i][k];
+            count++;
         }
+        return count;
+    }
 
-        for (int i = 0; i < face_count(); ++i)
+    IndexType TMesh::export_edges(std::span<std::uint32_t> indices, bool remove_infinite, bool keep_slots) const
+    {
+        assert(indices.size() == 6 * face_count());
+
+        auto removed = [&](int i_face)
+        { return is_free_face(i_face) || (remove_infinite && is_infinite_face(i_face)); };
+
+        IndexType count = 0;
+        for (IndexType i = 0; i < face_count(); ++i)
         {
-            if (remove_infinite && is_infinite_face(i))
-                continue;
-            mesh.triangle(m_faces[i][0], m_faces[i][1], m_faces[i][2]);
-        }
+            for (int k = 0; k < 3; ++k)
+            {
+                // The edge opposed to the vertex k.
+                int neighbor = m_faces[i](k);
+                bool owner = !removed(i) && (neighbor == -1 || removed(neighbor) || static_cast<int>(i) < neighbor);
 
-        return mesh;
+                IndexType slot = keep_slots ? 3 * i + k : count;
+                if (owner)
+                {
+                    indices[2 * slot] = m_faces[i][(k + 1) % 3];
+                    indices[2 * slot + 1] = m_faces[i][(k + 2) % 3];
+                    count++;
+                }
+                else if (keep_slots)
+                {
+                    indices[2 * slot] = indices[2 * slot + 1] = 0;
+                }
+            }
+        }
+        return count;
     }
 
     void TMesh::vertex_value(IndexType i_vertex, ScalarType v)
@@ -52,113 +168,89 @@ namespace gam
         return m_values[i_vertex];
     }
 
-    void gam::TMesh::load_off(const std::string &off_file)
+    bool TMesh::load_off(const std::string &off_file)
     {
-        m_vertices.clear();
-        m_faces.clear();
-        m_normals.clear();
-        m_curvature.clear();
-        m_values.clear();
+        GAM_TRACE_SCOPE("load_off");
+        clear();
 
-        std::ifstream file(std::string(OFF_DIR) + off_file);
+        MappedFile file(utils::data_directories().Off + off_file);
         // Checking if we can read the file
         if (!file.is_open())
         {
             utils::error("in [load_off] Couldn't open this file: ", off_file);
-            exit(1);
+            return false;
         }
+        TextReader reader(file.begin(), file.end());
         // Checking file type
-        std::string type;
-        file >> type;
-        if (type != "OFF")
+        if (!reader.keyword("OFF"))
         {
             utils::error("in [load_off] The format of the provided file must be OFF: ", off_file);
-            exit(1);
+            return false;
         }
         // Retrieving number of vertices / faces
         IndexType nVertices, nFaces, nEdges;
-        file >> nVertices >> nFaces >> nEdges;
+        if (!reader.read(nVertices) || !reader.read(nFaces) || !reader.read(nEdges))
+        {
+            utils::error("in [load_off] Invalid header line ", reader.line(), ": ", off_file);
+            return false;
+        }
         m_vertices.resize(nVertices);
         m_faces.resize(nFaces);
-        m_values.resize(nVertices, 0.);
-        m_curvature.resize(nVertices, 0.);
-        m_normals.resize(nVertices, Vector(0., 0., 1.));
 
-        Point pmin, pmax;
         // Initializing position of vertices
         for (IndexType i = 0; i < nVertices; ++i)
         {
-            Vertex vertex;
-            file >> vertex.X >> vertex.Y >> vertex.Z;
-            m_vertices[i] = vertex;
+            if (!reader.read(m_vertices.X[i]) || !reader.read(m_vertices.Y[i]) || !reader.read(m_vertices.Z[i]))
+            {
+                utils::error("in [load_off] Invalid vertex line ", reader.line(), ": ", off_file);
+                clear();
+                return false;
+            }
         }
 
-        std::unordered_map<std::pair<IndexType, IndexType>, std::pair<IndexType, int>, HashEdgePair> map;
         for (IndexType i = 0; i < nFaces; ++i)
         {
-            IndexType v0, v1, v2;
-            file >> nVertices >> v0 >> v1 >> v2;
-
-            // Set FaceIndex for each vertex if it's not already the case
-            if (m_vertices[v0].FaceIndex == -1)
-                m_vertices[v0].FaceIndex = i;
-            if (m_vertices[v1].FaceIndex == -1)
-                m_vertices[v1].FaceIndex = i;
-            if (m_vertices[v2].FaceIndex == -1)
-                m_vertices[v2].FaceIndex = i;
-            // Set vertex indices of the face i
-            m_faces[i][0] = v0;
-            assert(m_faces[i][0] != -1);
-            m_faces[i][1] = v1;
-            assert(m_faces[i][1] != -1);
-            m_faces[i][2] = v2;
-            assert(m_faces[i][2] != -1);
-            // Set neighboring faces using the edges
-            // Edge v0-v1
-            if (map.find({v0, v1}) == map.end() && map.find({v1, v0}) == map.end())
+            IndexType n, v0, v1, v2;
+            if (!reader.read(n) || !reader.read(v0) || !reader.read(v1) || !reader.read(v2))
             {
-                map[{v0, v1}] = {i, 2};
+                utils::error("in [load_off] Invalid face line ", reader.line(), ": ", off_file);
+                clear();
+                return false;
             }
-            else // The edge with v0 and v1 is already registered in map
+            if (n != 3 || v0 >= nVertices || v1 >= nVertices || v2 >= nVertices)
             {
-                auto [FaceIndex, EdgeIndex] = map[{v1, v0}];
-                m_faces[FaceIndex](EdgeIndex) = i;
-                m_faces[i](2) = FaceIndex;
-            }
-            // Edge v1-v2
-            if (map.find({v1, v2}) == map.end() && map.find({v2, v1}) == map.end())
-            {
-                map[{v1, v2}] = {i, 0};
-            }
-            else // The edge with v1 and v2 is already registered in map
-            {
-                auto [FaceIndex, EdgeIndex] = map[{v2, v1}];
-                m_faces[FaceIndex](EdgeIndex) = i;
-                m_faces[i](0) = FaceIndex;
-            }
-            // Edge v2-v0
-            if (map.find({v2, v0}) == map.end() && map.find({v0, v2}) == map.end())
-            {
-                map[{v2, v0}] = {i, 1};
-            }
-            else // The edge with v2 and v0 is already registered in map
-            {
-                auto [FaceIndex, EdgeIndex] = map[{v0, v2}];
-                m_faces[FaceIndex](EdgeIndex) = i;
-                m_faces[i](1) = FaceIndex;
+                utils::error("in [load_off] The face line ", reader.line(), " is not a triangle of valid vertices: ", off_file);
+                clear();
+                return false;
             }
+            m_faces[i].vertices(v0, v1, v2);
         }
 
+        // Set neighboring faces using the edges
+        if (!sew_faces())
+        {
+            utils::error("in [load_off] The mesh must be closed and manifold (every edge shared by exactly two faces): ", off_file);
+            clear();
+            return false;
+        }
+
+        m_values.resize(nVertices, 0.);
+        m_curvature.resize(nVertices, 0.);
+        m_normals.resize(nVertices, Vector(0., 0., 1.));
+
 #ifndef NDEBUG
         integrity_check();
         utils::status("[load_off] Integrity_check passed");
         utils::status("TMesh successfully loaded");
 #endif
-        file.close();
+        return true;
     }
+
     void TMesh::save_obj(const std::string &obj_file, bool use_curvature, bool remove_inf)
     {
-        std::ofstream file(std::string(OBJ_DIR) + obj_file);
+        GAM_TRACE_SCOPE("save_obj");
+        compact();
+        std::ofstream file(utils::data_directories().Obj + obj_file);
         file << "OBJ" << "\n";
 
         int f_count = face_count();
@@ -175,10 +267,9 @@ namespace gam
         file << v_count << " " << f_count << " " << 0 << "\n";
 
         // Save vertices position
-        for (int i = remove_inf ? 1 : 0; i < vertex_count(); ++i)
+        for (IndexType i = remove_inf ? 1 : 0; i < vertex_count(); ++i)
         {
-            auto v = m_vertices[i];
-            file << "v " << v.X << " " << v.Y << " " << v.Z << "\n";
+            file << "v " << m_vertices.X[i] << " " << m_vertices.Y[i] << " " << m_vertices.Z[i] << "\n";
         }
 
         if (!remove_inf)
@@ -216,12 +307,14 @@ namespace gam
             }
         }
         file.close();
-        utils::status("File ", obj_file, " successfully saved in data/obj");
+        utils::status("File ", obj_file, " successfully saved in ", utils::data_directories().Obj);
     }
 
     void TMesh::save_off(const std::string &off_file, bool remove_inf)
     {
-        std::ofstream file(std::string(OFF_DIR) + off_file);
+        GAM_TRACE_SCOPE("save_off");
+        compact();
+        std::ofstream file(utils::data_directories().Off + off_file);
         file << "OFF" << "\n";
 
         int f_count = face_count();
@@ -238,10 +331,9 @@ namespace gam
         file << v_count << " " << f_count << " " << 0 << "\n";
 
         // Save vertices position
-        for (int i = remove_inf ? 1 : 0; i < vertex_count(); ++i)
+        for (IndexType i = remove_inf ? 1 : 0; i < vertex_count(); ++i)
         {
-            auto v = m_vertices[i];
-            file << v.X << " " << v.Y << " " << v.Z << "\n";
+            file << m_vertices.X[i] << " " << m_vertices.Y[i] << " " << m_vertices.Z[i] << "\n";
         }
 
         // Save topology
@@ -259,7 +351,192 @@ namespace gam
             }
         }
         file.close();
-        utils::status("File ", off_file, " successfully saved in data/off");
+        utils::status("File ", off_file, " successfully saved in ", utils::data_directories().Off);
+    }
+
+    //! Header of a .tmesh file. It is followed by the arrays X, Y, Z, FaceIndex, faces, normals, values and curvature, stored verbatim in native byte order.
+    struct TMeshHeader
+    {
+        char Magic[4]{'T', 'M', 'S', 'H'};
+        std::uint32_t Version{TMESH_VERSION};
+        std::uint32_t VertexCount{0};
+        std::uint32_t FaceCount{0};
+        std::uint32_t NormalCount{0};
+        std::uint32_t ValueCount{0};
+        std::uint32_t CurvatureCount{0};
+        std::uint32_t Reserved{0};
+        //! Checksum of the arrays.
+        std::uint64_t Checksum{0};
+    };
+
+    static_assert(std::is_trivially_copyable_v<Face> && sizeof(Face) == 6 * sizeof(int));
+    static_assert(std::is_trivially_copyable_v<Vector> && sizeof(Vector) == 3 * sizeof(float));
+
+    //! FNV-1a hash of a block of memory, continuing from `hash`. Hashes 64-bit words, then the remaining bytes.
+    static std::uint64_t checksum(const char *data, std::size_t size, std::uint64_t hash = 14695981039346656037ull)
+    {
+        constexpr std::uint64_t prime = 1099511628211ull;
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+        return hash;
+    }
+
+    bool TMesh::save_tmesh(const std::string &tmesh_file) const
+    {
+        GAM_TRACE_SCOPE("save_tmesh");
+        TMeshHeader header;
+        header.VertexCount = vertex_count();
+        header.FaceCount = face_count();
+        header.NormalCount = m_normals.size();
+        header.ValueCount = m_values.size();
+        header.CurvatureCount = m_curvature.size();
+
+        const std::array<std::pair<const char *, std::size_t>, 8> sections{{
+            {reinterpret_cast<const char *>(m_vertices.X.data()), m_vertices.X.size() * sizeof(ScalarType)},
+            {reinterpret_cast<const char *>(m_vertices.Y.data()), m_vertices.Y.size() * sizeof(ScalarType)},
+            {reinterpret_cast<const char *>(m_vertices.Z.data()), m_vertices.Z.size() * sizeof(ScalarType)},
+            {reinterpret_cast<const char *>(m_vertices.FaceIndex.data()), m_vertices.FaceIndex.size() * sizeof(int)},
+            {reinterpret_cast<const char *>(m_faces.data()), m_faces.size() * sizeof(Face)},
+            {reinterpret_cast<const char *>(m_normals.data()), m_normals.size() * sizeof(Vector)},
+            {reinterpret_cast<const char *>(m_values.data()), m_values.size() * sizeof(ScalarType)},
+            {reinterpret_cast<const char *>(m_curvature.data()), m_curvature.size() * sizeof(ScalarType)},
+        }};
+
+        header.Checksum = checksum(nullptr, 0);
+        for (auto [data, size] : sections)
+            header.Checksum = checksum(data, size, header.Checksum);
+
+        std::filesystem::path path = utils::data_directories().TMesh + tmesh_file;
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            utils::error("in [save_tmesh] Couldn't create this file: ", tmesh_file);
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (auto [data, size] : sections)
+            file.write(data, size);
+
+        if (!file)
+        {
+            utils::error("in [save_tmesh] Couldn't write this file: ", tmesh_file);
+            return false;
+        }
+        utils::status("File ", tmesh_file, " successfully saved in ", utils::data_directories().TMesh);
+        return true;
+    }
+
+    bool TMesh::load_tmesh(const std::string &tmesh_file)
+    {
+        GAM_TRACE_SCOPE("load_tmesh");
+        clear();
+
+        MappedFile file(utils::data_directories().TMesh + tmesh_file);
+        if (!file.is_open())
+        {
+            utils::error("in [load_tmesh] Couldn't open this file: ", tmesh_file);
+            return false;
+        }
+
+        TMeshHeader header, expected;
+        if (file.size() < sizeof(header))
+        {
+            utils::error("in [load_tmesh] The file is truncated: ", tmesh_file);
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.Magic, expected.Magic, sizeof(header.Magic)) != 0 || header.Version != expected.Version)
+        {
+            utils::error("in [load_tmesh] The file is not a version ", TMESH_VERSION, " .tmesh file: ", tmesh_file);
+            return false;
+        }
+
+        // The per vertex arrays are either empty or complete : they are indexed by vertex.
+        for (std::uint32_t count : {header.NormalCount, header.ValueCount, header.CurvatureCount})
+        {
+            if (count != 0 && count != header.VertexCount)
+            {
+                utils::error("in [load_tmesh] The header counts are inconsistent: ", tmesh_file);
+                return false;
+            }
+        }
+
+        // The header is not covered by the checksum : the size is checked before allocating anything.
+        std::uint64_t file_size = sizeof(header);
+        file_size += static_cast<std::uint64_t>(header.VertexCount) * (3 * sizeof(ScalarType) + sizeof(int));
+        file_size += static_cast<std::uint64_t>(header.FaceCount) * sizeof(Face);
+        file_size += static_cast<std::uint64_t>(header.NormalCount) * sizeof(Vector);
+        file_size += static_cast<std::uint64_t>(header.ValueCount) * sizeof(ScalarType);
+        file_size += static_cast<std::uint64_t>(header.CurvatureCount) * sizeof(ScalarType);
+        if (file.size() != file_size)
+        {
+            utils::error("in [load_tmesh] The size of the file doesn't match its header: ", tmesh_file);
+            return false;
+        }
+
+        m_vertices.resize(header.VertexCount);
+        m_faces.resize(header.FaceCount);
+        m_normals.resize(header.NormalCount);
+        m_values.resize(header.ValueCount);
+        m_curvature.resize(header.CurvatureCount);
+
+        const std::array<std::pair<char *, std::size_t>, 8> sections{{
+            {reinterpret_cast<char *>(m_vertices.X.data()), m_vertices.X.size() * sizeof(ScalarType)},
+            {reinterpret_cast<char *>(m_vertices.Y.data()), m_vertices.Y.size() * sizeof(ScalarType)},
+            {reinterpret_cast<char *>(m_vertices.Z.data()), m_vertices.Z.size() * sizeof(ScalarType)},
+            {reinterpret_cast<char *>(m_vertices.FaceIndex.data()), m_vertices.FaceIndex.size() * sizeof(int)},
+            {reinterpret_cast<char *>(m_faces.data()), m_faces.size() * sizeof(Face)},
+            {reinterpret_cast<char *>(m_normals.data()), m_normals.size() * sizeof(Vector)},
+            {reinterpret_cast<char *>(m_values.data()), m_values.size() * sizeof(ScalarType)},
+            {reinterpret_cast<char *>(m_curvature.data()), m_curvature.size() * sizeof(ScalarType)},
+        }};
+
+        // The arrays are checked in the mapped file, then copied.
+        std::uint64_t hash = checksum(nullptr, 0);
+        const char *source = file.data() + sizeof(header);
+        for (auto [data, size] : sections)
+        {
+            hash = checksum(source, size, hash);
+            source += size;
+        }
+        if (hash != header.Checksum)
+        {
+            utils::error("in [load_tmesh] The checksum doesn't match, the file is corrupted: ", tmesh_file);
+            clear();
+            return false;
+        }
+
+        source = file.data() + sizeof(header);
+        for (auto [data, size] : sections)
+        {
+            if (size > 0)
+                std::memcpy(data, source, size);
+            source += size;
+        }
+
+        // The free slots are saved as they are.
+        for (IndexType i = 0; i < vertex_count(); ++i)
+        {
+            if (is_free_vertex(i))
+                m_free_vertices.push_back(i);
+        }
+        for (IndexType i = 0; i < face_count(); ++i)
+        {
+            if (is_free_face(i))
+                m_free_faces.push_back(i);
+        }
+
+        build_hierarchy();
+        return true;
     }
 
     IndexType TMesh::local_index(IndexType i_vertex, IndexType i_face) const
@@ -268,7 +545,7 @@ namespace gam
         assert(i_vertex < vertex_count());
 
         int localIndex = 0;
-        while (m_faces[i_face].Vertices[localIndex] != i_vertex && localIndex < 3)
+        while (localIndex < 3 && m_faces[i_face].Vertices[localIndex] != static_cast<int>(i_vertex))
             localIndex++;
         return localIndex;
     }
@@ -290,13 +567,13 @@ namespace gam
     {
         assert(i_vertex < face_count());
 
-        auto &faceStartIndex = m_vertices[i_vertex].FaceIndex;
+        auto &faceStartIndex = m_vertices.FaceIndex[i_vertex];
         utils::message("--Neighboring faces of vertex ", i_vertex, "--");
         int i = 0;
         utils::message("Neighboring face ", i++, ": ", faceStartIndex);
         IndexType localVertexIndex = local_index(i_vertex, faceStartIndex);
         IndexType currentFaceIndex = m_faces[faceStartIndex].Neighbors[(localVertexIndex + 1) % 3];
-        while (currentFaceIndex != faceStartIndex)
+        while (currentFaceIndex != static_cast<IndexType>(faceStartIndex))
         {
             utils::message("Neighboring face ", i++, ": ", currentFaceIndex);
             localVertexIndex = local_index(i_vertex, currentFaceIndex);
@@ -319,42 +596,19 @@ namespace gam
 
     std::vector<IndexType> TMesh::neighboring_faces_of_vertex(IndexType i_vertex) const
     {
-        assert(i_vertex < vertex_count());
-
         std::vector<IndexType> neighbors;
-        neighbors.emplace_back(m_vertices[i_vertex].FaceIndex);
-        IndexType localVertexIndex = local_index(i_vertex, neighbors[0]);
-        IndexType currentFaceIndex = m_faces[neighbors[0]].Neighbors[(localVertexIndex + 1) % 3];
-        while (currentFaceIndex != neighbors[0])
-        {
-            neighbors.emplace_back(currentFaceIndex);
-            localVertexIndex = local_index(i_vertex, currentFaceIndex);
-            currentFaceIndex = m_faces[currentFaceIndex].Neighbors[(localVertexIndex + 1) % 3];
-        }
+        for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                { neighbors.emplace_back(i_face); });
         return neighbors;
     }
 
     std::vector<IndexType> TMesh::neighboring_vertices_of_vertex(IndexType i_vertex) const
     {
-        assert(i_vertex < vertex_count());
-        assert(m_vertices[i_vertex].FaceIndex != -1);
+        assert(m_vertices.FaceIndex[i_vertex] != -1);
 
         std::vector<IndexType> neighbors;
-        IndexType startFaceIndex = m_vertices[i_vertex].FaceIndex;
-        IndexType currentFaceIndex = startFaceIndex;
-        IndexType localIndex = local_index(i_vertex, currentFaceIndex);
-        IndexType nextVertexLocalIndex = (localIndex + 1) % 3;
-        IndexType nextVertexGlobalIndex = m_faces[currentFaceIndex].Vertices[nextVertexLocalIndex];
-        neighbors.emplace_back(nextVertexGlobalIndex);
-        currentFaceIndex = m_faces[currentFaceIndex].Neighbors[nextVertexLocalIndex];
-        while (currentFaceIndex != startFaceIndex)
-        {
-            localIndex = local_index(i_vertex, currentFaceIndex);
-            nextVertexLocalIndex = (localIndex + 1) % 3;
-            nextVertexGlobalIndex = m_faces[currentFaceIndex].Vertices[nextVertexLocalIndex];
-            neighbors.emplace_back(nextVertexGlobalIndex);
-            currentFaceIndex = m_faces[currentFaceIndex].Neighbors[nextVertexLocalIndex];
-        }
+        for_each_vertex_of_vertex(i_vertex, [&](IndexType i_neighbor)
+                                  { neighbors.emplace_back(i_neighbor); });
         return neighbors;
     }
 
@@ -363,11 +617,11 @@ namespace gam
         assert(i_face < face_count());
 
         const auto &f = m_faces[i_face];
-        const Vertex &v0 = m_vertices[f.Vertices[0]];
-        const Vertex &v1 = m_vertices[f.Vertices[1]];
-        const Vertex &v2 = m_vertices[f.Vertices[2]];
-        Vector v0v1(Vertex::as_point(v0), Vertex::as_point(v1));
-        Vector v0v2(Vertex::as_point(v0), Vertex::as_point(v2));
+        Point v0 = m_vertices.point(f.Vertices[0]);
+        Point v1 = m_vertices.point(f.Vertices[1]);
+        Point v2 = m_vertices.point(f.Vertices[2]);
+        Vector v0v1(v0, v1);
+        Vector v0v2(v0, v2);
         Vector n = cross(v0v1, v0v2);
 
         return 0.5 * length(n);
@@ -376,22 +630,38 @@ namespace gam
     ScalarType TMesh::patch_area(IndexType i_vertex) const
     {
         assert(i_vertex < vertex_count());
-        auto iFaces = neighboring_faces_of_vertex(i_vertex);
         ScalarType area = 0.f;
-        for (auto i_face : iFaces)
-        {
-            area += face_area(i_face);
-        }
+        for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                { area += face_area(i_face); });
         return area / 3;
     }
 
     void TMesh::laplacian()
     {
         assert(m_values.size() == m_vertices.size());
-        for (IndexType i = 1; i < m_vertices.size(); ++i)
-        {
-            m_values[i] = laplacian(i);
-        }
+
+        std::vector<ScalarType> &Lu = m_laplacian_values;
+        laplacian_operator().multiply(m_values, Lu);
+        parallel_for(vertex_count(), [&](IndexType begin, IndexType end)
+                     {
+            for (IndexType i = std::max<IndexType>(begin, 1); i < end; ++i)
+            {
+                m_values[i] = Lu[i] / m_lumped_mass[i];
+            } });
+    }
+
+    const SparseMatrix &TMesh::laplacian_operator()
+    {
+        if (m_operator_dirty)
+            build_laplacian_operator();
+        return m_laplacian_operator;
+    }
+
+    const std::vector<ScalarType> &TMesh::lumped_mass()
+    {
+        if (m_operator_dirty)
+            build_laplacian_operator();
+        return m_lumped_mass;
     }
 
     Vector TMesh::face_normal(IndexType i_face) const
@@ -400,8 +670,8 @@ namespace gam
 
         auto faceVertices = m_faces[i_face].Vertices;
 
-        Vector u(Vertex::as_point(m_vertices[faceVertices[0]]), Vertex::as_point(m_vertices[faceVertices[1]]));
-        Vector v(Vertex::as_point(m_vertices[faceVertices[0]]), Vertex::as_point(m_vertices[faceVertices[2]]));
+        Vector u(m_vertices.point(faceVertices[0]), m_vertices.point(faceVertices[1]));
+        Vector v(m_vertices.point(faceVertices[0]), m_vertices.point(faceVertices[2]));
 
         Vector faceNormal = cross(u, v);
 
@@ -410,44 +680,70 @@ namespace gam
 
     void TMesh::smooth_normals()
     {
+        GAM_TRACE_SCOPE("smooth_normals");
         assert(m_normals.size() == m_vertices.size());
 
-        for (IndexType i = 0; i < m_vertices.size(); ++i)
-        {
-            Vector laplacian = laplacian_vector(i);
+        const SparseMatrix &L = laplacian_operator();
+        std::vector<ScalarType> Lx, Ly, Lz;
+        L.multiply(m_vertices.X, Lx);
+        L.multiply(m_vertices.Y, Ly);
+        L.multiply(m_vertices.Z, Lz);
 
-            IndexType i_face = m_vertices[i].FaceIndex;
-            Vector faceNormal = face_normal(i_face);
-
-            Vector vertexNormal = laplacian;
-            if (dot(faceNormal, laplacian) < 0)
+        parallel_for(vertex_count(), [&](IndexType begin, IndexType end)
+                     {
+            for (IndexType i = begin; i < end; ++i)
             {
-                vertexNormal = -vertexNormal;
-            }
+                if (is_free_vertex(i))
+                {
+                    m_curvature[i] = 0;
+                    m_normals[i] = Vector();
+                    continue;
+                }
+                Vector laplacian = Vector(Lx[i], Ly[i], Lz[i]) / m_lumped_mass[i];
 
-            m_curvature[i] = length(vertexNormal);
-            m_normals[i] = vertexNormal;
-        }
+                IndexType i_face = m_vertices.FaceIndex[i];
+                Vector faceNormal = face_normal(i_face);
+
+                Vector vertexNormal = laplacian;
+                if (dot(faceNormal, laplacian) < 0)
+                {
+                    vertexNormal = -vertexNormal;
+                }
+
+                m_curvature[i] = length(vertexNormal);
+                m_normals[i] = vertexNormal;
+            } });
     }
 
     void TMesh::curvature()
     {
+        GAM_TRACE_SCOPE("curvature");
         ScalarType maxCurv = *std::max_element(m_curvature.begin(), m_curvature.end());
 
         assert(maxCurv > 0 || maxCurv < 0);
 
-        for (IndexType i = 0; i < m_vertices.size(); ++i)
-        {
-            m_curvature[i] = m_curvature[i] / maxCurv;
-        }
+        parallel_for(vertex_count(), [&](IndexType begin, IndexType end)
+                     {
+            for (IndexType i = begin; i < end; ++i)
+            {
+                m_curvature[i] = m_curvature[i] / maxCurv;
+            } });
     }
 
     void TMesh::heat_diffusion(ScalarType delta_time)
     {
-        for (int i = 1; i < vertex_count(); ++i)
-        {
-            heat_diffusion(i, delta_time);
-        }
+        GAM_TRACE_SCOPE("heat_diffusion");
+        assert(m_values.size() == m_vertices.size());
+
+        // Explicit Euler step : every vertex is updated from the values of the previous step (the vertex 0 is the fixed heat source).
+        std::vector<ScalarType> &Lu = m_laplacian_values;
+        laplacian_operator().multiply(m_values, Lu);
+        parallel_for(vertex_count(), [&](IndexType begin, IndexType end)
+                     {
+            for (IndexType i = std::max<IndexType>(begin, 1); i < end; ++i)
+            {
+                m_values[i] += delta_time * Lu[i] / m_lumped_mass[i];
+            } });
     }
 
     void TMesh::heat_diffusion(IndexType i_vertex, ScalarType delta_time)
@@ -457,6 +753,43 @@ namespace gam
         m_values[i_vertex] += delta_time * laplacian(i_vertex);
     }
 
+    SolverStats TMesh::heat_diffusion_implicit(ScalarType delta_time)
+    {
+        GAM_TRACE_SCOPE("heat_diffusion_implicit");
+        assert(m_values.size() == m_vertices.size());
+
+        const SparseMatrix &L = laplacian_operator();
+        const auto &mass = lumped_mass();
+
+        // A = M - dt L. The vertex 0 is a fixed value (Dirichlet condition) : its row and column are removed from the system, its column goes to the right-hand side.
+        SparseMatrix A = L;
+        std::vector<double> b(vertex_count());
+        for (IndexType i = 0; i < vertex_count(); ++i)
+        {
+            b[i] = mass[i] * m_values[i];
+            for (IndexType k = A.RowStart[i]; k < A.RowStart[i + 1]; ++k)
+            {
+                IndexType j = A.Columns[k];
+                A.Values[k] = (i == j ? mass[i] : 0.) - delta_time * L.Values[k];
+                if (i == 0 || j == 0)
+                {
+                    if (i != 0)
+                        b[i] -= A.Values[k] * m_values[0];
+                    A.Values[k] = i == j ? 1. : 0.;
+                }
+            }
+        }
+        b[0] = m_values[0];
+
+        std::vector<double> u(m_values.begin(), m_values.end());
+        m_solver_stats = conjugate_gradient(A, b, u);
+        if (!m_solver_stats.Converged)
+            utils::info("[heat_diffusion_implicit] The conjugate gradient did not converge, residual : ", m_solver_stats.Residual);
+
+        std::copy(u.begin(), u.end(), m_values.begin());
+        return m_solver_stats;
+    }
+
     void TMesh::insert_vertex(float x, float y, float z)
     {
         insert_vertex({x, y, z});
@@ -469,111 +802,212 @@ namespace gam
         m_normals.clear();
         m_curvature.clear();
         m_values.clear();
+        m_point_vertex_indices.clear();
+        m_vertex_point_indices.clear();
+        m_face_stamps.clear();
+        m_stamp = 0;
+        m_free_vertices.clear();
+        m_free_faces.clear();
+        m_hierarchy.clear();
+        m_operator_dirty = true;
+        m_last_face = 0;
+        reset_walk_stats();
     }
 
     ScalarType TMesh::laplacian(IndexType i_vertex)
     {
         assert(m_values.size() == m_vertices.size());
 
-        ScalarType Lui = 0.;
-        auto neighboringVertices = neighboring_vertices_of_vertex(i_vertex);
-        auto numOfNeighbors = neighboringVertices.size();
-        for (size_t j = 1; j <= numOfNeighbors; ++j)
-        {
-            assert(j - 1 >= 0);
-
-            IndexType jVertex = neighboringVertices[j % numOfNeighbors];
-            IndexType prevJVertex = neighboringVertices[j - 1];
-            IndexType nextJVertex = neighboringVertices[(j + 1) % numOfNeighbors];
+        return laplacian_operator().row_product(i_vertex, m_values) / m_lumped_mass[i_vertex];
+    }
 
-            // Cotangente
-            Vector v(Vertex::as_point(m_vertices[prevJVertex]), Vertex::as_point(m_vertices[jVertex]));
-            Vector w(Vertex::as_point(m_vertices[prevJVertex]), Vertex::as_point(m_vertices[i_vertex]));
-            ScalarType cotAlpha = cotan(v, w);
-            v = Vector(Vertex::as_point(m_vertices[nextJVertex]), Vertex::as_point(m_vertices[i_vertex]));
-            w = Vector(Vertex::as_point(m_vertices[nextJVertex]), Vertex::as_point(m_vertices[jVertex]));
-            ScalarType cotBeta = cotan(v, w);
-            ScalarType &ui = m_values[i_vertex];
-            ScalarType &uj = m_values[jVertex];
+    Vector TMesh::laplacian_vector(IndexType i_vertex)
+    {
+        const SparseMatrix &L = laplacian_operator();
+        Vector laplacian(L.row_product(i_vertex, m_vertices.X), L.row_product(i_vertex, m_vertices.Y), L.row_product(i_vertex, m_vertices.Z));
 
-            Lui += (cotAlpha + cotBeta) * (uj - ui);
-        }
-        return Lui / (2. * patch_area(i_vertex));
+        return laplacian / m_lumped_mass[i_vertex];
     }
 
-    Vector TMesh::laplacian_vector(IndexType i_vertex)
+    void TMesh::build_laplacian_operator()
     {
-        assert(m_values.size() == m_vertices.size());
-        Vector laplacian;
-        auto neighboringVertices = neighboring_vertices_of_vertex(i_vertex);
-        auto numOfNeighbors = neighboringVertices.size();
-        for (size_t j = 1; j <= numOfNeighbors; ++j)
+        GAM_TRACE_SCOPE("build_laplacian_operator");
+        // The free slots are skipped rather than compacted, so that the indices held by the caller stay valid : a free vertex only has its diagonal entry, which stays 0.
+        // Each vertex is connected to itself and to the two other vertices of each of its faces (sorted, without duplicates).
+        std::vector<IndexType> start(vertex_count() + 1, 0);
+        for (IndexType i = 0; i < vertex_count(); ++i)
+            start[i + 1] = 1;
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
         {
-            assert(j - 1 >= 0);
-            IndexType jVertex = neighboringVertices[j % numOfNeighbors];
-            IndexType prevJVertex = neighboringVertices[j - 1];
-            IndexType nextJVertex = neighboringVertices[(j + 1) % numOfNeighbors];
+            if (is_free_face(i_face))
+                continue;
+            for (int k = 0; k < 3; ++k)
+                start[m_faces[i_face][k] + 1] += 2;
+        }
+        std::partial_sum(start.begin(), start.end(), start.begin());
 
-            // Cotangente
-            Vector pj(Vertex::as_point(m_vertices[prevJVertex]), Vertex::as_point(m_vertices[jVertex]));
-            Vector pi(Vertex::as_point(m_vertices[prevJVertex]), Vertex::as_point(m_vertices[i_vertex]));
-            ScalarType cotAlpha = cotan(pj, pi);
-            Vector ni = Vector(Vertex::as_point(m_vertices[nextJVertex]), Vertex::as_point(m_vertices[i_vertex]));
-            Vector nj = Vector(Vertex::as_point(m_vertices[nextJVertex]), Vertex::as_point(m_vertices[jVertex]));
-            ScalarType cotBeta = cotan(ni, nj);
-            auto &vi = m_vertices[i_vertex];
-            auto &vj = m_vertices[jVertex];
-            Vector ui = Vector(vi.X, vi.Y, vi.Z);
-            Vector uj = Vector(vj.X, vj.Y, vj.Z);
+        std::vector<IndexType> candidates(start.back());
+        std::vector<IndexType> next(start.begin(), start.end() - 1);
+        for (IndexType i = 0; i < vertex_count(); ++i)
+            candidates[next[i]++] = i;
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
+        {
+            if (is_free_face(i_face))
+                continue;
+            const Face &face = m_faces[i_face];
+            for (int k = 0; k < 3; ++k)
+            {
+                candidates[next[face[k]]++] = face[(k + 1) % 3];
+                candidates[next[face[k]]++] = face[(k + 2) % 3];
+            }
+        }
 
-            laplacian.x += (cotAlpha + cotBeta) * (uj.x - ui.x);
-            laplacian.y += (cotAlpha + cotBeta) * (uj.y - ui.y);
-            laplacian.z += (cotAlpha + cotBeta) * (uj.z - ui.z);
+        SparseMatrix &L = m_laplacian_operator;
+        L.clear();
+        L.RowStart.reserve(vertex_count() + 1);
+        L.RowStart.emplace_back(0);
+        for (IndexType i = 0; i < vertex_count(); ++i)
+        {
+            auto begin = candidates.begin() + start[i];
+            auto end = candidates.begin() + start[i + 1];
+            std::sort(begin, end);
+            L.Columns.insert(L.Columns.end(), begin, std::unique(begin, end));
+            L.RowStart.emplace_back(L.Columns.size());
+        }
+        L.Values.assign(L.non_zeros(), 0.);
+        m_lumped_mass.assign(vertex_count(), 0.);
+
+        // The corner k of a face adds half of its cotangent to the weight of the opposite edge (i, j), and a third of the face area to the mass of its vertex.
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
+        {
+            if (is_free_face(i_face))
+                continue;
+            const Face &face = m_faces[i_face];
+            ScalarType area = face_area(i_face) / 3;
+            for (int k = 0; k < 3; ++k)
+            {
+                IndexType i = face[(k + 1) % 3];
+                IndexType j = face[(k + 2) % 3];
+                Point corner = m_vertices.point(face[k]);
+                double weight = 0.5 * cotan(Vector(corner, m_vertices.point(i)), Vector(corner, m_vertices.point(j)));
+
+                L.Values[L.find(i, j)] += weight;
+                L.Values[L.find(j, i)] += weight;
+                L.Values[L.find(i, i)] -= weight;
+                L.Values[L.find(j, j)] -= weight;
+                m_lumped_mass[face[k]] += area;
+            }
         }
-        laplacian = laplacian / (2. * patch_area(i_vertex));
 
-        return laplacian;
+        // A free vertex gets a unit mass : the divisions by the mass stay finite and its row of the implicit system keeps its value.
+        for (IndexType i : m_free_vertices)
+            m_lumped_mass[i] = 1.;
+
+        m_operator_dirty = false;
+    }
+
+    IndexType TMesh::insert_vertex(const Point &p)
+    {
+        return insert_vertex(p, start_face(p));
     }
 
-    void TMesh::insert_vertex(const Point &p)
+    IndexType TMesh::insert_vertex(const Point &p, IndexType i_hint_face)
     {
-        auto loc = locate_triangle(p);
+        m_operator_dirty = true;
+
+        auto loc = locate_triangle(p, i_hint_face, m_walk_steps);
+        m_locate_count++;
         bool found = loc.first;
         int i_face = loc.second.first;
         int i_edge = loc.second.second;
 
+        if (m_insertion_engine == InsertionEngine::BowyerWatson && in_conflict(p, i_face))
+        {
+            IndexType i_vertex = insert_cavity(p, i_face);
+            if (m_values.size() < vertex_count())
+                m_values.emplace_back(p.z);
+            m_last_face = m_vertices.FaceIndex[i_vertex];
+            hierarchy_insert(0, i_vertex);
+            return i_vertex;
+        }
+
+        // The Lawson insertion also handles the points that are not in conflict with their face (already inserted points).
+        IndexType i_vertex;
         if (found) // p is in a face
         {
             if (i_edge >= 0)
             {
-                edge_split(p, i_face, i_edge);
+                i_vertex = edge_split(p, i_face, i_edge);
             }
             else
             {
-                triangle_split(p, i_face);
+                i_vertex = triangle_split(p, i_face);
             }
         }
         else // point is outside every faces
         {
-            insert_outside(p, i_face);
+            i_vertex = insert_outside(p, i_face);
         }
 
-        lawson(vertex_count() - 1);
+        if (m_values.size() < vertex_count())
+            m_values.emplace_back(p.z);
+
+        lawson(i_vertex);
+
+        m_last_face = m_vertices.FaceIndex[i_vertex];
+        hierarchy_insert(0, i_vertex);
+        return i_vertex;
     }
 
-    void TMesh::lawson(IndexType i_vertex)
+    IndexType TMesh::start_face(const Point &p)
     {
-        auto faces = neighboring_faces_of_vertex(i_vertex);
-
-        std::stack<IndexType> to_check;
+        switch (m_locate_strategy)
+        {
+        case LocateStrategy::LastInserted:
+            return m_last_face < face_count() ? m_last_face : 0;
+        case LocateStrategy::Hierarchy:
+            return hierarchy_start_face(p, 0, m_walk_steps);
+        case LocateStrategy::JumpAndWalk:
+        {
+            // Sample about n^(1/3) vertices and start from the nearest one.
+            IndexType n = vertex_count() - 1;
+            IndexType samples = std::max<IndexType>(1, std::cbrt(static_cast<float>(n)));
+            std::uniform_int_distribution<IndexType> uniform(1, n);
+
+            IndexType i_nearest = 1;
+            ScalarType nearest = std::numeric_limits<ScalarType>::max();
+            for (IndexType i = 0; i < samples; ++i)
+            {
+                IndexType i_vertex = uniform(m_rng);
+                if (is_free_vertex(i_vertex))
+                    continue;
+                ScalarType dx = m_vertices.X[i_vertex] - p.x;
+                ScalarType dy = m_vertices.Y[i_vertex] - p.y;
+                if (dx * dx + dy * dy < nearest)
+                {
+                    nearest = dx * dx + dy * dy;
+                    i_nearest = i_vertex;
+                }
+            }
+            return is_free_vertex(i_nearest) ? m_last_face : m_vertices.FaceIndex[i_nearest];
+        }
+        default:
+            return 0;
+        }
+    }
 
-        for (auto i_face : faces)
-            to_check.push(i_face);
+    void TMesh::lawson(IndexType i_vertex)
+    {
+        GAM_COUNT(LawsonCalls, 1);
+        std::vector<IndexType> &to_check = insertion_scratch().FlipStack;
+        to_check.clear();
+        for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                { to_check.push_back(i_face); });
 
         while (!to_check.empty())
         {
-            IndexType i_face0 = to_check.top();
-            to_check.pop();
+            IndexType i_face0 = to_check.back();
+            to_check.pop_back();
             if (is_infinite_face(i_face0))
                 continue;
 
@@ -586,15 +1020,16 @@ namespace gam
             Face face1 = m_faces[i_face1];
             IndexType i_edge1 = face1.get_edge(i_face0);
 
-            Vertex p = m_vertices[face1[i_edge1]];
-            Vertex a = m_vertices[face0[0]];
-            Vertex b = m_vertices[face0[1]];
-            Vertex c = m_vertices[face0[2]];
-            if (in_circle(Vertex::as_point(p), Vertex::as_point(a), Vertex::as_point(b), Vertex::as_point(c)))
+            Point p = m_vertices.point(face1[i_edge1]);
+            Point a = m_vertices.point(face0[0]);
+            Point b = m_vertices.point(face0[1]);
+            Point c = m_vertices.point(face0[2]);
+            if (in_circle(p, a, b, c))
             {
                 flip_edge(i_face0, i_edge0);
-                to_check.push(i_face0);
-                to_check.push(i_face1);
+                GAM_COUNT(LawsonFlips, 1);
+                to_check.push_back(i_face0);
+                to_check.push_back(i_face1);
             }
         }
 
@@ -604,6 +1039,817 @@ namespace gam
         // #endif
     }
 
+    bool TMesh::in_conflict(const Point &p, IndexType i_face) const
+    {
+        const Face &face = m_faces[i_face];
+        for (int i = 0; i < 3; ++i)
+        {
+            if (face.Vertices[i] != 0)
+                continue;
+
+            // Infinite face (0, u, v) : the hull is on the right of u -> v.
+            Point u = m_vertices.point(face.Vertices[(i + 1) % 3]);
+            Point v = m_vertices.point(face.Vertices[(i + 2) % 3]);
+            int o = orientation(u, v, p);
+            if (o != 0)
+                return o > 0;
+            return (double(p.x) - u.x) * (double(p.x) - v.x) + (double(p.y) - u.y) * (double(p.y) - v.y) < 0.;
+        }
+
+        return circle_side(p, m_vertices.point(face.Vertices[0]), m_vertices.point(face.Vertices[1]), m_vertices.point(face.Vertices[2])) > 0;
+    }
+
+    IndexType TMesh::insert_cavity(const Point &p, IndexType i_face)
+    {
+        InsertionScratch &scratch = insertion_scratch();
+        std::vector<IndexType> &cavity = scratch.Cavity;
+        std::vector<CavityEdge> &border = scratch.Border;
+        cavity.clear();
+        border.clear();
+
+        if (m_face_stamps.size() < face_count() + 2)
+            m_face_stamps.resize(std::max<std::size_t>(face_count() + 2, 2 * m_face_stamps.size()), 0);
+        if (m_stamp >= std::numeric_limits<std::uint32_t>::max() - 2)
+        {
+            std::fill(m_face_stamps.begin(), m_face_stamps.end(), 0);
+            m_stamp = 0;
+        }
+        m_stamp += 2;
+        const std::uint32_t inside = m_stamp, outside = m_stamp + 1;
+
+        // The faces in conflict with p are connected : they are found by a traversal from the face of p.
+        cavity.push_back(i_face);
+        m_face_stamps[i_face] = inside;
+        for (std::size_t k = 0; k < cavity.size(); ++k)
+        {
+            const Face &face = m_faces[cavity[k]];
+            for (int i = 0; i < 3; ++i)
+            {
+                IndexType i_neighbor = face.Neighbors[i];
+                std::uint32_t &stamp = m_face_stamps[i_neighbor];
+                if (stamp == inside || stamp == outside)
+                {
+                    if (stamp == outside)
+                        border.push_back({static_cast<IndexType>(face.Vertices[(i + 1) % 3]), static_cast<IndexType>(face.Vertices[(i + 2) % 3]), cavity[k], i_neighbor});
+                    continue;
+                }
+                if (in_conflict(p, i_neighbor))
+                {
+                    stamp = inside;
+                    cavity.push_back(i_neighbor);
+                }
+                else
+                {
+                    stamp = outside;
+                    border.push_back({static_cast<IndexType>(face.Vertices[(i + 1) % 3]), static_cast<IndexType>(face.Vertices[(i + 2) % 3]), cavity[k], i_neighbor});
+                }
+            }
+        }
+        GAM_COUNT(Cavities, 1);
+        GAM_COUNT(CavityFaces, cavity.size());
+
+        // The cavity is a disk whose vertices are all on its border : p is joined to the border by cavity.size() + 2 faces.
+        assert(border.size() == cavity.size() + 2);
+        IndexType i_vertex = new_vertex(p, cavity[0]);
+        cavity.push_back(new_face());
+        cavity.push_back(new_face());
+
+        std::vector<std::pair<IndexType, IndexType>> &starts = scratch.BorderStarts;
+        starts.clear();
+        for (IndexType i_edge = 0; i_edge < border.size(); ++i_edge)
+            starts.emplace_back(border[i_edge].A, i_edge);
+        std::sort(starts.begin(), starts.end());
+        auto next_edge = [&](IndexType i_edge)
+        { return std::lower_bound(starts.begin(), starts.end(), std::make_pair(border[i_edge].B, IndexType(0)))->second; };
+
+
+        // The face (p, a, b) of the edge (a, b) : its neighbor opposed to a is the face of the next edge (b, c), the one opposed to b the face of the previous edge.
+        for (IndexType i_edge = 0; i_edge < border.size(); ++i_edge)
+        {
+            const CavityEdge &edge = border[i_edge];
+            IndexType i_face_edge = cavity[i_edge];
+            IndexType i_face_next = cavity[next_edge(i_edge)];
+
+            m_faces[i_face_edge].Vertices[0] = i_vertex;
+            m_faces[i_face_edge].Vertices[1] = edge.A;
+            m_faces[i_face_edge].Vertices[2] = edge.B;
+            m_faces[i_face_edge].Neighbors[0] = edge.Outside;
+            m_faces[i_face_edge].Neighbors[1] = i_face_next;
+            m_faces[i_face_next].Neighbors[2] = i_face_edge;
+
+            Face &outer = m_faces[edge.Outside];
+            for (int i = 0; i < 3; ++i)
+            {
+                if (static_cast<IndexType>(outer.Vertices[i]) != edge.A && static_cast<IndexType>(outer.Vertices[i]) != edge.B)
+                    outer.Neighbors[i] = i_face_edge;
+            }
+            m_vertices.FaceIndex[edge.A] = i_face_edge;
+        }
+
+        // The infinite vertex stays the first vertex of the infinite faces.
+        for (IndexType i_edge = 0; i_edge < border.size(); ++i_edge)
+        {
+            Face &face = m_faces[cavity[i_edge]];
+            if (face.Vertices[1] == 0)
+                face.slide_vertices_left();
+            else if (face.Vertices[2] == 0)
+                face.slide_vertices_left(), face.slide_vertices_left();
+        }
+
+#ifdef DEBUG
+        integrity_check();
+        utils::status("[insert_cavity] Integrity_check passed");
+#endif
+        return i_vertex;
+    }
+
+    IndexType TMesh::new_face()
+    {
+        if (m_free_faces.empty())
+        {
+            m_faces.emplace_back();
+            return face_count() - 1;
+        }
+        IndexType i_face = m_free_faces.back();
+        m_free_faces.pop_back();
+        return i_face;
+    }
+
+    IndexType TMesh::new_vertex(const Point &p, IndexType i_face)
+    {
+        if (m_free_vertices.empty())
+        {
+            m_vertices.emplace_back(p, i_face);
+            return vertex_count() - 1;
+        }
+        IndexType i_vertex = m_free_vertices.back();
+        m_free_vertices.pop_back();
+        m_vertices.position(i_vertex, p);
+        m_vertices.FaceIndex[i_vertex] = i_face;
+        if (i_vertex < m_values.size())
+            m_values[i_vertex] = p.z;
+        return i_vertex;
+    }
+
+    //! Power of p with respect to the circumcircle of the counterclockwise triangle (a, b, c), in double precision : it orders the ears of remove_vertex, the exact predicates check them.
+    static double circle_power(const Point &p, const Point &a, const Point &b, const Point &c)
+    {
+        double adx = double(a.x) - p.x, ady = double(a.y) - p.y;
+        double bdx = double(b.x) - p.x, bdy = double(b.y) - p.y;
+        double cdx = double(c.x) - p.x, cdy = double(c.y) - p.y;
+        double in_circle = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+        double area = (double(b.x) - a.x) * (double(c.y) - a.y) - (double(b.y) - a.y) * (double(c.x) - a.x);
+        return -in_circle / area;
+    }
+
+    bool TMesh::remove_vertex(IndexType i_vertex)
+    {
+        assert(i_vertex < vertex_count());
+        if (i_vertex == 0 || is_free_vertex(i_vertex))
+            return false;
+
+        InsertionScratch &scratch = insertion_scratch();
+        std::vector<IndexType> &faces = scratch.HoleFaces;
+        std::vector<IndexType> &vertices = scratch.HoleVertices;
+        std::vector<IndexType> &edge_faces = scratch.EdgeFaces;
+        faces.clear();
+        vertices.clear();
+        edge_faces.clear();
+
+        // The hole is the polygon of the neighbors of the vertex, counterclockwise : its edge k goes from vertices[k] to vertices[k + 1], edge_faces[k] is the face on its other side.
+        for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                {
+            IndexType i = ring_index(i_vertex, i_face);
+            faces.push_back(i_face);
+            vertices.push_back(m_faces[i_face].Vertices[(i + 1) % 3]);
+            edge_faces.push_back(m_faces[i_face].Neighbors[i]); });
+        IndexType degree = faces.size();
+
+        std::vector<IndexType> &next = scratch.Next;
+        std::vector<IndexType> &previous = scratch.Previous;
+        next.resize(degree);
+        previous.resize(degree);
+        for (IndexType k = 0; k < degree; ++k)
+        {
+            next[k] = (k + 1) % degree;
+            previous[k] = (k + degree - 1) % degree;
+        }
+
+        Point p = m_vertices.point(i_vertex);
+        auto point = [&](IndexType k)
+        { return m_vertices.point(vertices[k]); };
+
+        // The ear of the polygon at k, (previous, k, next), is a face of the Delaunay triangulation without the vertex if no other vertex of the polygon is in its circumcircle. An infinite ear (0, s, t) is a hull edge s -> t if no other vertex is beyond it.
+        auto is_delaunay_ear = [&](IndexType k)
+        {
+            IndexType a = previous[k], c = next[k];
+            IndexType i_infinite = vertices[a] == 0 ? a : (vertices[k] == 0 ? k : (vertices[c] == 0 ? c : degree));
+            if (i_infinite == degree && orientation(point(a), point(k), point(c)) <= 0)
+                return false;
+
+            IndexType s = i_infinite == a ? k : (i_infinite == k ? c : a);
+            IndexType t = i_infinite == a ? c : (i_infinite == k ? a : k);
+            for (IndexType w = next[c]; w != a; w = next[w])
+            {
+                if (vertices[w] == 0)
+                    continue;
+                if (i_infinite == degree)
+                {
+                    if (circle_side(point(w), point(a), point(k), point(c)) > 0)
+                        return false;
+                    continue;
+                }
+                Point q = point(w), u = point(s), v = point(t);
+                int o = orientation(u, v, q);
+                if (o > 0 || (o == 0 && (double(q.x) - u.x) * (double(q.x) - v.x) + (double(q.y) - u.y) * (double(q.y) - v.y) < 0.))
+                    return false;
+            }
+            return true;
+        };
+
+        // Ear queue : the ears are tried by increasing power of the removed vertex with respect to their circumcircle (the infinite ears the vertex is beyond first), the first Delaunay ear is cut.
+        std::vector<std::pair<double, IndexType>> &ears = scratch.Ears;
+        std::vector<std::array<IndexType, 3>> &cuts = scratch.Cuts;
+        cuts.clear();
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        IndexType first = 0;
+        for (IndexType count = degree; count > 3; --count)
+        {
+            ears.clear();
+            IndexType k = first;
+            do
+            {
+                IndexType a = previous[k], c = next[k];
+                if (vertices[a] == 0 || vertices[k] == 0 || vertices[c] == 0)
+                {
+                    // The infinite ear (0, s, t) is the half plane on the left of s -> t.
+                    IndexType s = vertices[a] == 0 ? k : (vertices[k] == 0 ? c : a);
+                    IndexType t = vertices[a] == 0 ? c : (vertices[k] == 0 ? a : k);
+                    ears.emplace_back(orientation(point(s), point(t), p) > 0 ? -infinity : infinity, k);
+                }
+                else if (orientation(point(a), point(k), point(c)) > 0)
+                {
+                    ears.emplace_back(circle_power(p, point(a), point(k), point(c)), k);
+                }
+                k = next[k];
+            } while (k != first);
+            std::sort(ears.begin(), ears.end());
+
+            auto ear = std::find_if(ears.begin(), ears.end(), [&](const auto &e)
+                                    { return is_delaunay_ear(e.second); });
+            if (ear == ears.end())
+                return false;
+
+            k = ear->second;
+            cuts.push_back({previous[k], k, next[k]});
+            next[previous[k]] = next[k];
+            previous[next[k]] = previous[k];
+            first = next[k];
+        }
+        if (!is_delaunay_ear(first))
+            return false;
+        cuts.push_back({previous[first], first, next[first]});
+
+        // Without a finite face in the hole or around it, the remaining vertices are aligned.
+        bool finite = std::any_of(cuts.begin(), cuts.end(), [&](const auto &cut)
+                                  { return vertices[cut[0]] != 0 && vertices[cut[1]] != 0 && vertices[cut[2]] != 0; }) ||
+                      std::any_of(edge_faces.begin(), edge_faces.end(), [&](IndexType i_face)
+                                  { return !is_infinite_face(i_face); });
+        if (!finite)
+            return false;
+
+        // The ears reuse the lowest slots of the hole, the face 0 stays in use.
+        std::sort(faces.begin(), faces.end());
+        auto link = [&](IndexType i_face, IndexType a, IndexType b, IndexType i_new)
+        {
+            Face &face = m_faces[i_face];
+            for (int i = 0; i < 3; ++i)
+            {
+                if (static_cast<IndexType>(face.Vertices[i]) != a && static_cast<IndexType>(face.Vertices[i]) != b)
+                    face.Neighbors[i] = i_new;
+            }
+        };
+        for (IndexType i_cut = 0; i_cut < cuts.size(); ++i_cut)
+        {
+            auto [a, k, c] = cuts[i_cut];
+            IndexType i_face = faces[i_cut];
+            bool last = i_cut + 1 == cuts.size();
+
+            // The edge c -> a is shared with a later ear, except for the last one.
+            Face face(vertices[a], vertices[k], vertices[c], edge_faces[k], last ? static_cast<int>(edge_faces[c]) : -1, edge_faces[a]);
+            link(edge_faces[k], vertices[k], vertices[c], i_face);
+            link(edge_faces[a], vertices[a], vertices[k], i_face);
+            if (last)
+                link(edge_faces[c], vertices[c], vertices[a], i_face);
+            edge_faces[a] = i_face;
+
+            if (face.Vertices[1] == 0)
+                face.slide_vertices_left();
+            else if (face.Vertices[2] == 0)
+                face.slide_vertices_left(), face.slide_vertices_left();
+            m_faces[i_face] = face;
+            for (int i = 0; i < 3; ++i)
+                m_vertices.FaceIndex[face.Vertices[i]] = i_face;
+        }
+
+        for (IndexType i = cuts.size(); i < degree; ++i)
+        {
+            m_faces[faces[i]] = Face();
+            m_free_faces.push_back(faces[i]);
+        }
+        m_vertices.FaceIndex[i_vertex] = -1;
+        m_free_vertices.push_back(i_vertex);
+
+        GAM_COUNT(VertexRemovals, 1);
+        GAM_COUNT(RemovalFaces, cuts.size());
+        m_last_face = faces[0];
+        m_operator_dirty = true;
+        hierarchy_remove(0, i_vertex);
+
+        // The other vertices keep their slot : only the entry of the removed one changes.
+        IndexType i_point = vertex_point_index(i_vertex);
+        if (i_point != NO_POINT)
+        {
+            m_point_vertex_indices[i_point] = 0;
+            m_vertex_point_indices[i_vertex] = NO_POINT;
+        }
+
+#ifdef DEBUG
+        integrity_check();
+        utils::status("[remove_vertex] Integrity_check passed");
+#endif
+        return true;
+    }
+
+    bool TMesh::move_vertex(IndexType i_vertex, const Point &p)
+    {
+        return move_vertices({&i_vertex, 1}, {&p, 1}) == 0;
+    }
+
+    IndexType TMesh::move_vertices(std::span<const IndexType> indices, std::span<const Point> positions)
+    {
+        assert(indices.size() == positions.size());
+        GAM_TRACE_SCOPE("move_vertices");
+
+        InsertionScratch &scratch = insertion_scratch();
+        std::vector<std::pair<IndexType, IndexType>> &edges = scratch.MovedEdges;
+        edges.clear();
+
+        // The moves left to a removal and an insertion, and the vertices moved in place that have copies in the hierarchy (the levels use the scratch buffers too).
+        std::vector<IndexType> reinsertions;
+        std::vector<IndexType> moved;
+
+        // The moves are done along the Hilbert curve of the new positions, as the insertions, so that consecutive moves touch the same faces.
+        std::vector<IndexType> &order = scratch.MoveOrder;
+        order.resize(indices.size());
+        std::iota(order.begin(), order.end(), IndexType(0));
+        hilbert_sort(positions, order.begin(), order.end());
+
+        // Each accepted move leaves a valid triangulation, the next moves are tested against it. The edges of the faces around a moved vertex are the only ones that may not be Delaunay anymore : each face pushes its edge opposed to the vertex and one of its edges to the vertex, so that every edge is tested once.
+        for (IndexType k : order)
+        {
+            IndexType i_vertex = indices[k];
+            assert(i_vertex < vertex_count());
+            // The removal refuses the infinite vertex and the free vertices.
+            if (i_vertex == 0 || is_free_vertex(i_vertex) || !keeps_star(i_vertex, positions[k]))
+            {
+                reinsertions.push_back(k);
+                continue;
+            }
+
+            m_vertices.position(i_vertex, positions[k]);
+            if (i_vertex < m_values.size())
+                m_values[i_vertex] = positions[k].z;
+            for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                    {
+                IndexType i = ring_index(i_vertex, i_face);
+                edges.emplace_back(i_face, i);
+                edges.emplace_back(i_face, (i + 1) % 3); });
+            if (!m_hierarchy.empty())
+                moved.push_back(i_vertex);
+            GAM_COUNT(VertexMoves, 1);
+        }
+        legalize(edges);
+        hierarchy_move(moved);
+        m_operator_dirty = true;
+
+        // The removal needs a Delaunay triangulation : the other moves come after the flips. The vertex gets its slot back, the last one freed.
+        IndexType failures = 0;
+        for (IndexType k : reinsertions)
+        {
+            IndexType i_vertex = indices[k];
+            IndexType i_point = vertex_point_index(i_vertex);
+            bool removed = remove_vertex(i_vertex);
+            if (removed)
+            {
+                insert_vertex(positions[k], m_last_face);
+                assert(!is_free_vertex(i_vertex));
+                if (i_point != NO_POINT)
+                {
+                    m_point_vertex_indices[i_point] = i_vertex;
+                    m_vertex_point_indices[i_vertex] = i_point;
+                }
+                GAM_COUNT(VertexMoves, 1);
+                GAM_COUNT(MoveReinsertions, 1);
+            }
+            else
+                failures++;
+        }
+        return failures;
+    }
+
+    void TMesh::locate_strategy(LocateStrategy strategy)
+    {
+        if (strategy == m_locate_strategy)
+            return;
+        m_locate_strategy = strategy;
+        build_hierarchy();
+    }
+
+    IndexType TMesh::hierarchy_level_count() const
+    {
+        IndexType count = 0;
+        while (count < m_hierarchy.size() && m_hierarchy[count].Mesh.face_count() > 0)
+            count++;
+        return count;
+    }
+
+    std::size_t TMesh::hierarchy_memory() const
+    {
+        std::size_t bytes = m_hierarchy.size() * sizeof(HierarchyLevel);
+        for (const HierarchyLevel &level : m_hierarchy)
+        {
+            const TMesh &mesh = level.Mesh;
+            bytes += mesh.vertex_count() * (3 * sizeof(ScalarType) + sizeof(int)) + mesh.face_count() * sizeof(Face);
+            bytes += mesh.m_values.size() * sizeof(ScalarType);
+            bytes += (level.Down.size() + level.Up.size()) * sizeof(IndexType);
+        }
+        return bytes;
+    }
+
+    void TMesh::build_hierarchy()
+    {
+        m_hierarchy.clear();
+        if (m_locate_strategy != LocateStrategy::Hierarchy)
+            return;
+
+        GAM_TRACE_SCOPE("build_hierarchy");
+        for (IndexType i_vertex = 1; i_vertex < vertex_count(); ++i_vertex)
+        {
+            if (!is_free_vertex(i_vertex))
+                hierarchy_insert(0, i_vertex);
+        }
+    }
+
+    void TMesh::hierarchy_insert(IndexType level, IndexType i_lower)
+    {
+        if (m_locate_strategy != LocateStrategy::Hierarchy || level >= HIERARCHY_MAX_LEVELS || !promoted(level, i_lower))
+            return;
+
+        // The levels are added by the recursive calls : the references are not used after them.
+        if (level == m_hierarchy.size())
+        {
+            m_hierarchy.emplace_back();
+            m_hierarchy.back().Mesh.insertion_engine(m_insertion_engine);
+        }
+        const TMesh &lower = level == 0 ? *this : m_hierarchy[level - 1].Mesh;
+        HierarchyLevel &upper = m_hierarchy[level];
+        if (upper.Up.size() < lower.vertex_count())
+            upper.Up.resize(lower.vertex_count(), 0);
+
+        if (upper.Mesh.face_count() > 0)
+        {
+            // The walks of the upper levels maintain the hierarchy, they are kept out of the walk statistics of the mesh.
+            Point p = lower.m_vertices.point(i_lower);
+            std::uint64_t steps = 0;
+            IndexType i_upper = upper.Mesh.insert_vertex(p, hierarchy_start_face(p, level + 1, steps));
+            if (upper.Down.size() <= i_upper)
+                upper.Down.resize(i_upper + 1, 0);
+            upper.Down[i_upper] = i_lower;
+            upper.Up[i_lower] = i_upper;
+            hierarchy_insert(level + 1, i_upper);
+            return;
+        }
+
+        // The level is triangulated as soon as its vertices are not all aligned.
+        std::vector<IndexType> &pending = upper.Down;
+        pending.push_back(i_lower);
+        bool aligned = true;
+        for (IndexType i = 2; i < pending.size() && aligned; ++i)
+            aligned = orientation(lower.m_vertices.point(pending[0]), lower.m_vertices.point(pending[1]), lower.m_vertices.point(pending[i])) == 0;
+        if (aligned)
+            return;
+
+        std::vector<Point> points;
+        points.reserve(pending.size());
+        for (IndexType i_vertex : pending)
+            points.push_back(lower.m_vertices.point(i_vertex));
+        upper.Mesh.insert_vertices(points, -1, false);
+
+        const std::vector<IndexType> &indices = upper.Mesh.point_vertex_indices();
+        std::vector<IndexType> down(upper.Mesh.vertex_count(), 0);
+        for (IndexType i = 0; i < pending.size(); ++i)
+        {
+            down[indices[i]] = pending[i];
+            upper.Up[pending[i]] = indices[i];
+        }
+        upper.Down = std::move(down);
+
+        IndexType count = upper.Mesh.vertex_count();
+        for (IndexType i_upper = 1; i_upper < count; ++i_upper)
+            hierarchy_insert(level + 1, i_upper);
+    }
+
+    void TMesh::hierarchy_remove(IndexType level, IndexType i_lower)
+    {
+        if (level >= m_hierarchy.size())
+            return;
+
+        HierarchyLevel &upper = m_hierarchy[level];
+        if (upper.Mesh.face_count() == 0)
+        {
+            upper.Down.erase(std::remove(upper.Down.begin(), upper.Down.end(), i_lower), upper.Down.end());
+            return;
+        }
+
+        IndexType i_upper = i_lower < upper.Up.size() ? upper.Up[i_lower] : 0;
+        if (i_upper == 0)
+            return;
+        // A level can not lose a vertex if the others are aligned : the hierarchy is built again.
+        if (!upper.Mesh.remove_vertex(i_upper))
+        {
+            build_hierarchy();
+            return;
+        }
+        upper.Up[i_lower] = 0;
+        upper.Down[i_upper] = 0;
+        hierarchy_remove(level + 1, i_upper);
+    }
+
+    void TMesh::hierarchy_move(std::vector<IndexType> &indices)
+    {
+        // The copies keep their slots : the moves of a level give the vertices to move in the level above.
+        std::vector<IndexType> uppers;
+        std::vector<Point> positions;
+        for (IndexType level = 0; level < hierarchy_level_count() && !indices.empty(); ++level)
+        {
+            const TMesh &lower = level == 0 ? *this : m_hierarchy[level - 1].Mesh;
+            HierarchyLevel &upper = m_hierarchy[level];
+            uppers.clear();
+            positions.clear();
+            for (IndexType i_lower : indices)
+            {
+                IndexType i_upper = i_lower < upper.Up.size() ? upper.Up[i_lower] : 0;
+                if (i_upper == 0)
+                    continue;
+                uppers.push_back(i_upper);
+                positions.push_back(lower.m_vertices.point(i_lower));
+            }
+            if (upper.Mesh.move_vertices(uppers, positions) > 0)
+            {
+                build_hierarchy();
+                return;
+            }
+            std::swap(indices, uppers);
+        }
+    }
+
+    IndexType TMesh::hierarchy_start_face(const Point &p, IndexType level, std::uint64_t &steps) const
+    {
+        IndexType i_vertex = 0;
+        for (IndexType k = hierarchy_level_count(); k > level; --k)
+        {
+            const TMesh &mesh = m_hierarchy[k - 1].Mesh;
+            IndexType i_start = i_vertex == 0 ? (mesh.m_last_face < mesh.face_count() ? mesh.m_last_face : 0) : mesh.m_vertices.FaceIndex[i_vertex];
+            IndexType i_face = mesh.locate_triangle(p, i_start, steps).second.first;
+
+            // The walk below starts from the nearest finite vertex of the face.
+            const Face &face = mesh.m_faces[i_face];
+            IndexType i_nearest = 0;
+            double nearest = std::numeric_limits<double>::max();
+            for (IndexType i = 0; i < 3; ++i)
+            {
+                IndexType i_candidate = face.Vertices[i];
+                if (i_candidate == 0)
+                    continue;
+                double dx = static_cast<double>(mesh.m_vertices.X[i_candidate]) - p.x;
+                double dy = static_cast<double>(mesh.m_vertices.Y[i_candidate]) - p.y;
+                if (dx * dx + dy * dy < nearest)
+                {
+                    nearest = dx * dx + dy * dy;
+                    i_nearest = i_candidate;
+                }
+            }
+            i_vertex = m_hierarchy[k - 1].Down[i_nearest];
+        }
+
+        const TMesh &mesh = level == 0 ? *this : m_hierarchy[level - 1].Mesh;
+        if (i_vertex == 0 || mesh.is_free_vertex(i_vertex))
+            return mesh.m_last_face < mesh.face_count() ? mesh.m_last_face : 0;
+        return mesh.m_vertices.FaceIndex[i_vertex];
+    }
+
+    bool TMesh::keeps_star(IndexType i_vertex, const Point &p) const
+    {
+        bool valid = true;
+        for_each_face_of_vertex(i_vertex, [&](IndexType i_face)
+                                {
+            const Face &face = m_faces[i_face];
+            IndexType i = ring_index(i_vertex, i_face);
+            IndexType a = face.Vertices[(i + 1) % 3];
+            IndexType b = face.Vertices[(i + 2) % 3];
+            valid = valid && a != 0 && b != 0 && orientation(p, m_vertices.point(a), m_vertices.point(b)) > 0; });
+        return valid;
+    }
+
+    IndexType TMesh::vertex_point_index(IndexType i_vertex)
+    {
+        if (m_vertex_point_indices.empty() && !m_point_vertex_indices.empty())
+        {
+            m_vertex_point_indices.assign(vertex_count(), NO_POINT);
+            for (IndexType i = 0; i < m_point_vertex_indices.size(); ++i)
+            {
+                if (m_point_vertex_indices[i] != 0)
+                    m_vertex_point_indices[m_point_vertex_indices[i]] = i;
+            }
+        }
+        return i_vertex < m_vertex_point_indices.size() ? m_vertex_point_indices[i_vertex] : NO_POINT;
+    }
+
+    void TMesh::compact()
+    {
+        if (m_free_vertices.empty() && m_free_faces.empty())
+            return;
+        GAM_TRACE_SCOPE("compact");
+
+        // The slots keep their order : the slot i moves to map[i] <= i.
+        constexpr IndexType removed = std::numeric_limits<IndexType>::max();
+        std::vector<IndexType> vertex_map(vertex_count(), removed);
+        std::vector<IndexType> face_map(face_count(), removed);
+        IndexType new_vertex_count = 0, new_face_count = 0;
+        for (IndexType i = 0; i < vertex_count(); ++i)
+        {
+            if (!is_free_vertex(i))
+                vertex_map[i] = new_vertex_count++;
+        }
+        for (IndexType i = 0; i < face_count(); ++i)
+        {
+            if (!is_free_face(i))
+                face_map[i] = new_face_count++;
+        }
+
+        auto compact_vertex_array = [&](auto &values)
+        {
+            if (values.size() != vertex_map.size())
+                return;
+            for (IndexType i = 0; i < vertex_map.size(); ++i)
+            {
+                if (vertex_map[i] != removed)
+                    values[vertex_map[i]] = values[i];
+            }
+            values.resize(new_vertex_count);
+        };
+        for (IndexType i = 0; i < vertex_count(); ++i)
+        {
+            if (vertex_map[i] != removed)
+                m_vertices.FaceIndex[i] = face_map[m_vertices.FaceIndex[i]];
+        }
+        compact_vertex_array(m_vertices.X);
+        compact_vertex_array(m_vertices.Y);
+        compact_vertex_array(m_vertices.Z);
+        compact_vertex_array(m_vertices.FaceIndex);
+        compact_vertex_array(m_values);
+        compact_vertex_array(m_normals);
+        compact_vertex_array(m_curvature);
+
+        for (IndexType i = 0; i < face_map.size(); ++i)
+        {
+            if (face_map[i] == removed)
+                continue;
+            Face face = m_faces[i];
+            for (int k = 0; k < 3; ++k)
+            {
+                face.Vertices[k] = vertex_map[face.Vertices[k]];
+                face.Neighbors[k] = face_map[face.Neighbors[k]];
+            }
+            m_faces[face_map[i]] = face;
+        }
+        m_faces.resize(new_face_count);
+
+        for (IndexType &i_vertex : m_point_vertex_indices)
+            i_vertex = vertex_map[i_vertex] == removed ? 0 : vertex_map[i_vertex];
+        m_vertex_point_indices.clear();
+        m_last_face = m_last_face < face_map.size() && face_map[m_last_face] != removed ? face_map[m_last_face] : 0;
+        m_free_vertices.clear();
+        m_free_faces.clear();
+        m_face_stamps.clear();
+        m_stamp = 0;
+        m_operator_dirty = true;
+
+        // The levels of the hierarchy refer to the old indices.
+        build_hierarchy();
+    }
+
+    void TMesh::legalize(std::vector<std::pair<IndexType, IndexType>> &edges)
+    {
+        while (!edges.empty())
+        {
+            auto [i_face0, i_edge0] = edges.back();
+            edges.pop_back();
+            if (is_infinite_face(i_face0))
+                continue;
+
+            IndexType i_face1 = m_faces[i_face0](i_edge0);
+            if (is_infinite_face(i_face1))
+                continue;
+
+            const Face &face0 = m_faces[i_face0];
+            const Face &face1 = m_faces[i_face1];
+            Point p = m_vertices.point(face1[face1.get_edge(i_face0)]);
+            Point a = m_vertices.point(face0[0]);
+            Point b = m_vertices.point(face0[1]);
+            Point c = m_vertices.point(face0[2]);
+            if (circle_side(p, a, b, c) > 0)
+            {
+                flip_edge(i_face0, i_edge0);
+                // The four edges of the quadrilateral may not be Delaunay anymore.
+                edges.emplace_back(i_face0, 1);
+                edges.emplace_back(i_face0, 2);
+                edges.emplace_back(i_face1, 1);
+                edges.emplace_back(i_face1, 2);
+            }
+        }
+    }
+
+    bool TMesh::sew_faces()
+    {
+        GAM_TRACE_SCOPE("sew_faces");
+        // The open half-edges are bucketed by the smallest index of their vertices (counting sort) : the two halves of an edge land in the same short bucket.
+        auto origin = [this](IndexType half_edge) -> IndexType
+        { return m_faces[half_edge / 3][(half_edge % 3 + 1) % 3]; };
+        auto target = [this](IndexType half_edge) -> IndexType
+        { return m_faces[half_edge / 3][(half_edge % 3 + 2) % 3]; };
+
+        std::vector<IndexType> bucket_start(vertex_count() + 1, 0);
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                if (m_faces[i_face](i) == -1)
+                    bucket_start[std::min(origin(3 * i_face + i), target(3 * i_face + i)) + 1]++;
+            }
+        }
+        for (IndexType i = 0; i < vertex_count(); ++i)
+            bucket_start[i + 1] += bucket_start[i];
+
+        std::vector<IndexType> half_edges(bucket_start.back());
+        std::vector<IndexType> position(bucket_start.begin(), bucket_start.end() - 1);
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                if (m_faces[i_face](i) == -1)
+                    half_edges[position[std::min(origin(3 * i_face + i), target(3 * i_face + i))]++] = 3 * i_face + i;
+            }
+        }
+
+        for (IndexType i_vertex = 0; i_vertex < vertex_count(); ++i_vertex)
+        {
+            for (IndexType k = bucket_start[i_vertex]; k < bucket_start[i_vertex + 1]; ++k)
+            {
+                IndexType h0 = half_edges[k];
+                if (m_faces[h0 / 3](h0 % 3) != -1)
+                    continue; // already matched
+
+                // The twin goes from the target of h0 to its origin, and must be unique.
+                IndexType other = std::max(origin(h0), target(h0));
+                int twin = -1;
+                for (IndexType l = k + 1; l < bucket_start[i_vertex + 1]; ++l)
+                {
+                    IndexType h1 = half_edges[l];
+                    if (std::max(origin(h1), target(h1)) != other)
+                        continue;
+                    if (twin != -1 || origin(h1) == origin(h0))
+                        return false; // edge shared by more than two faces, or faces not consistently oriented
+                    twin = h1;
+                }
+                if (twin == -1)
+                    return false; // boundary edge
+
+                m_faces[h0 / 3](h0 % 3) = twin / 3;
+                m_faces[twin / 3](twin % 3) = h0 / 3;
+            }
+        }
+
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
+        {
+            for (int i = 0; i < 3; ++i)
+                m_vertices.FaceIndex[m_faces[i_face][i]] = i_face;
+        }
+
+        return true;
+    }
+
     void TMesh::slide_triangle(IndexType i_face)
     {
         assert(i_face < face_count());
@@ -628,9 +1874,11 @@ namespace gam
         return face[0] == 0 || face[1] == 0 || face[2] == 0;
     }
 
-    std::pair<bool, std::pair<int, int>> TMesh::locate_triangle(const Point &p) const
+    std::pair<bool, std::pair<int, int>> TMesh::locate_triangle(const Point &p, IndexType i_start, std::uint64_t &steps) const
     {
-        int i_face = 0;
+        // The walk must start from a finite face : the finite neighbor of an infinite face is opposed to the infinite vertex.
+        int i_face = is_infinite_face(i_start) ? m_faces[i_start](0) : i_start;
+        [[maybe_unused]] std::uint64_t start_steps = steps;
         int i_edge = 0;
 
         int i_edge_to_avoid = -1;
@@ -658,8 +1906,8 @@ namespace gam
 
             bool p_intersect_f = false;
             int tmp_i_edge = -1;
-            Point a = Vertex::as_point(m_vertices[m_faces[i_face][(i_edge + 2) % 3]]);
-            Point b = Vertex::as_point(m_vertices[m_faces[i_face][(i_edge + 1) % 3]]);
+            Point a = m_vertices.point(m_faces[i_face][(i_edge + 2) % 3]);
+            Point b = m_vertices.point(m_faces[i_face][(i_edge + 1) % 3]);
             while (!p_in_f && (o = orientation(a, b, p)) < 1) // clockwise or on edge
             {
                 if (o == 0)
@@ -682,8 +1930,8 @@ namespace gam
                     continue;
                 }
 
-                a = Vertex::as_point(m_vertices[m_faces[i_face][(i_edge + 2) % 3]]);
-                b = Vertex::as_point(m_vertices[m_faces[i_face][(i_edge + 1) % 3]]);
+                a = m_vertices.point(m_faces[i_face][(i_edge + 2) % 3]);
+                b = m_vertices.point(m_faces[i_face][(i_edge + 1) % 3]);
             }
 
             if (p_in_f)
@@ -691,31 +1939,33 @@ namespace gam
 
             i_previous_face = i_face;
             i_face = m_faces[i_face](i_edge);
+            steps++;
             i_edge_to_avoid = m_faces[i_face].get_edge(i_previous_face);
         } while (!p_in_f && !f_is_inf);
 
+        GAM_COUNT(Locates, 1);
+        GAM_COUNT(WalkSteps, steps - start_steps);
         return {!f_is_inf, {i_face, i_edge}};
     }
 
-    void TMesh::triangle_split(const Point &p, IndexType i_face)
+    IndexType TMesh::triangle_split(const Point &p, IndexType i_face)
     {
+        GAM_COUNT(TriangleSplits, 1);
         auto face = m_faces[i_face];
 
-        int i_vertex = vertex_count();
+        IndexType i_vertex = new_vertex(p, i_face);
 
-        m_vertices.emplace_back(p, i_face);
-
-        IndexType i_face2 = face_count();
-        IndexType i_face3 = face_count() + 1;
+        IndexType i_face2 = new_face();
+        IndexType i_face3 = new_face();
 
         m_faces[i_face][2] = i_vertex;
         m_faces[i_face](0) = i_face2;
         m_faces[i_face](1) = i_face3;
 
-        m_faces.emplace_back(face[1], face[2], i_vertex, i_face3, i_face, face(0));
-        m_faces.emplace_back(face[2], face[0], i_vertex, i_face, i_face2, face(1));
+        m_faces[i_face2] = Face(face[1], face[2], i_vertex, i_face3, i_face, face(0));
+        m_faces[i_face3] = Face(face[2], face[0], i_vertex, i_face, i_face2, face(1));
 
-        m_vertices[face[2]].FaceIndex = i_face2;
+        m_vertices.FaceIndex[face[2]] = i_face2;
 
         m_faces[face(0)].change_neighbor(i_face, i_face2);
         m_faces[face(1)].change_neighbor(i_face, i_face3);
@@ -724,15 +1974,16 @@ namespace gam
         integrity_check();
         utils::status("[triangle_split] Integrity_check passed");
 #endif
+        return i_vertex;
     }
 
-    void TMesh::edge_split(const Point &p, IndexType i_face0, IndexType i_edge0)
+    IndexType TMesh::edge_split(const Point &p, IndexType i_face0, IndexType i_edge0)
     {
-        IndexType i_vertex = vertex_count();
-        m_vertices.emplace_back(p, i_face0);
+        GAM_COUNT(EdgeSplits, 1);
+        IndexType i_vertex = new_vertex(p, i_face0);
 
-        IndexType i_face2 = face_count();
-        IndexType i_face3 = face_count() + 1;
+        IndexType i_face2 = new_face();
+        IndexType i_face3 = new_face();
 
         IndexType i_face1 = m_faces[i_face0](i_edge0);
         IndexType i_edge1 = m_faces[i_face1].get_edge(i_face0);
@@ -746,10 +1997,10 @@ namespace gam
         m_faces[i_face1].vertices(face1[i_edge1], i_vertex, face1[(i_edge1 + 2) % 3]);
         m_faces[i_face1].neighbors(face1(i_edge1), face1((i_edge1 + 1) % 3), i_face2);
 
-        m_faces.emplace_back(face1[i_edge1], face1[(i_edge1 + 1) % 3], i_vertex, i_face3, i_face1, face1((i_edge1 + 2) % 3));
-        m_faces.emplace_back(face0[i_edge0], i_vertex, face0[(i_edge0 + 2) % 3], i_face2, face0((i_edge0 + 1) % 3), i_face0);
+        m_faces[i_face2] = Face(face1[i_edge1], face1[(i_edge1 + 1) % 3], i_vertex, i_face3, i_face1, face1((i_edge1 + 2) % 3));
+        m_faces[i_face3] = Face(face0[i_edge0], i_vertex, face0[(i_edge0 + 2) % 3], i_face2, face0((i_edge0 + 1) % 3), i_face0);
 
-        m_vertices[face0[(i_edge0 + 2) % 3]].FaceIndex = i_face2;
+        m_vertices.FaceIndex[face0[(i_edge0 + 2) % 3]] = i_face2;
 
         m_faces[face0((i_edge0 + 1) % 3)].change_neighbor(i_face0, i_face3);
         m_faces[face1((i_edge1 + 2) % 3)].change_neighbor(i_face1, i_face2);
@@ -758,13 +2009,14 @@ namespace gam
         integrity_check();
         utils::status("[edge_split] Integrity_check passed");
 #endif
+        return i_vertex;
     }
 
     void TMesh::check_orientation(Face& face)
     {
-        Point a = Vertex::as_point(m_vertices[face[0]]);
-        Point b = Vertex::as_point(m_vertices[face[1]]);
-        Point c = Vertex::as_point(m_vertices[face[2]]);
+        Point a = m_vertices.point(face[0]);
+        Point b = m_vertices.point(face[1]);
+        Point c = m_vertices.point(face[2]);
         if (orientation(a, b, c) != 1)
         {
             IndexType tmp = face[1];
@@ -773,48 +2025,60 @@ namespace gam
         }
     }
 
-    void TMesh::insert_outside(const Point &p, IndexType i_face)
+    IndexType TMesh::insert_outside(const Point &p, IndexType i_face)
     {
-        auto nf = neighboring_faces_of_vertex(0);
+        std::vector<IndexType> &nf = insertion_scratch().HullFaces;
+        nf.clear();
+        for_each_face_of_vertex(0, [&](IndexType i_face)
+                                { nf.push_back(i_face); });
+        // The faces around the infinite vertex, and the hull edges that stop the two walks below.
+        GAM_COUNT(InsertOutside, 1);
+        GAM_COUNT(HullWalkSteps, nf.size() + 2);
 
         int itf = std::find(nf.begin(), nf.end(), i_face) - nf.begin();
 
-        triangle_split(p, i_face);
+        IndexType i_vertex = triangle_split(p, i_face);
 
-        slide_triangle(face_count() - 1); // we check the last added face.
+        slide_triangle(m_faces[i_face](1)); // we check the last added face.
 
         // check right
         int i = (itf - 1 + nf.size()) % nf.size();
-        Point a = Vertex::as_point(m_vertices[m_faces[nf[i]][1]]);
-        Point b = Vertex::as_point(m_vertices[m_faces[nf[i]][2]]);
+        Point a = m_vertices.point(m_faces[nf[i]][1]);
+        Point b = m_vertices.point(m_faces[nf[i]][2]);
         while (orientation(a, b, p) == 1)
         {
             flip_edge(nf[i], 1);
+            GAM_COUNT(HullWalkSteps, 1);
             i = (i - 1 + nf.size()) % nf.size();
-            a = Vertex::as_point(m_vertices[m_faces[nf[i]][1]]);
-            b = Vertex::as_point(m_vertices[m_faces[nf[i]][2]]);
+            a = m_vertices.point(m_faces[nf[i]][1]);
+            b = m_vertices.point(m_faces[nf[i]][2]);
         }
 
         i = (itf + 1) % nf.size();
-        a = Vertex::as_point(m_vertices[m_faces[nf[i]][1]]);
-        b = Vertex::as_point(m_vertices[m_faces[nf[i]][2]]);
+        a = m_vertices.point(m_faces[nf[i]][1]);
+        b = m_vertices.point(m_faces[nf[i]][2]);
         while (orientation(a, b, p) == 1)
         {
             flip_edge(nf[i], 2);
+            GAM_COUNT(HullWalkSteps, 1);
             i = (i + 1) % nf.size();
-            a = Vertex::as_point(m_vertices[m_faces[nf[i]][1]]);
-            b = Vertex::as_point(m_vertices[m_faces[nf[i]][2]]);
+            a = m_vertices.point(m_faces[nf[i]][1]);
+            b = m_vertices.point(m_faces[nf[i]][2]);
         }
+        return i_vertex;
     }
 
     void TMesh::flip_edge(IndexType i_face0, IndexType i_edge0)
     {
+        GAM_COUNT(Flips, 1);
         IndexType i_face1 = m_faces[i_face0](i_edge0);
         IndexType i_edge1 = m_faces[i_face1].get_edge(i_face0);
 
         Face face0 = m_faces[i_face0];
         Face face1 = m_faces[i_face1];
 
+        m_operator_dirty = true;
+
         m_faces[i_face0][0] = face0[(i_edge0 + 1) % 3];
         m_faces[i_face0][1] = face1[i_edge1];
         m_faces[i_face0][2] = face0[i_edge0];
@@ -829,8 +2093,8 @@ namespace gam
         m_faces[i_face1](1) = face1((i_edge1 + 2) % 3);
         m_faces[i_face1](2) = face0((i_edge0 + 1) % 3);
 
-        m_vertices[face0[(i_edge0 + 1) % 3]].FaceIndex = i_face0;
-        m_vertices[face1[(i_edge1 + 1) % 3]].FaceIndex = i_face1;
+        m_vertices.FaceIndex[face0[(i_edge0 + 1) % 3]] = i_face0;
+        m_vertices.FaceIndex[face1[(i_edge1 + 1) % 3]] = i_face1;
 
         m_faces[face0((i_edge0 + 1) % 3)].change_neighbor(i_face0, i_face1);
         m_faces[face1((i_edge1 + 1) % 3)].change_neighbor(i_face1, i_face0);
@@ -841,8 +2105,9 @@ namespace gam
 #endif
     }
 
-    void TMesh::insert_vertices(const std::vector<Point> &points, int point_count)
+    bool TMesh::insert_vertices(const std::vector<Point> &points, int point_count, bool spatial_sort, const ProgressCallback &progress)
     {
+        GAM_TRACE_SCOPE("insert_vertices");
         assert(points.size() >= 3);
 
         clear();
@@ -850,19 +2115,44 @@ namespace gam
         if (point_count == -1)
             point_count = points.size();
 
-        m_values.reserve(points.size());
-        for (const auto &p : points)
+        std::vector<IndexType> order;
+        if (spatial_sort)
         {
-            m_values.emplace_back(p.z);
+            order = brio_order(points, point_count);
+        }
+        else
+        {
+            order.resize(point_count);
+            std::iota(order.begin(), order.end(), IndexType(0));
         }
 
-        m_vertices.reserve(points.size() + 1);
+        // The first face must not be degenerated : we look for a point that is not aligned with the two first ones.
+        for (int i = 2; i < point_count; ++i)
+        {
+            if (orientation(points[order[0]], points[order[1]], points[order[i]]) != 0)
+            {
+                std::swap(order[2], order[i]);
+                break;
+            }
+        }
+
+        // The vertex of index i + 1 is created for the point order[i] (the vertex 0 is the infinite vertex).
+        m_point_vertex_indices.resize(point_count);
+        m_values.reserve(point_count + 1);
+        m_values.emplace_back(0.);
+        for (int i = 0; i < point_count; ++i)
+        {
+            m_point_vertex_indices[order[i]] = i + 1;
+            m_values.emplace_back(points[order[i]].z);
+        }
+
+        m_vertices.reserve(point_count + 1);
 
         m_vertices.emplace_back(0., 0., -1., 1);
 
-        m_vertices.emplace_back(points[0].x, points[0].y, 0, 0);
-        m_vertices.emplace_back(points[1].x, points[1].y, 0, 0);
-        m_vertices.emplace_back(points[2].x, points[2].y, 0, 0);
+        m_vertices.emplace_back(points[order[0]].x, points[order[0]].y, 0, 0);
+        m_vertices.emplace_back(points[order[1]].x, points[order[1]].y, 0, 0);
+        m_vertices.emplace_back(points[order[2]].x, points[order[2]].y, 0, 0);
 
         m_faces.emplace_back(1, 2, 3, 2, 3, 1);
         check_orientation(m_faces[0]); 
@@ -872,10 +2162,17 @@ namespace gam
         m_faces.emplace_back(0, face0[1], face0[0], 0, face0(1), face0(0));
         m_faces.emplace_back(0, face0[2], face0[1], 0, face0(2), face0(1));
         m_faces.emplace_back(0, face0[0], face0[2], 0, face0(0), face0(2));
+        for (IndexType i = 1; i <= 3; ++i)
+            hierarchy_insert(0, i);
 
         for (int i = 3; i < point_count; ++i)
         {
-            insert_vertex(points[i].x, points[i].y, 0.0);
+            if (progress && i % PROGRESS_INTERVAL == 0 && !progress(static_cast<float>(i) / point_count))
+            {
+                clear();
+                return false;
+            }
+            insert_vertex(points[order[i]].x, points[order[i]].y, 0.0);
         }
 
 #ifndef NDEBUG
@@ -885,30 +2182,31 @@ namespace gam
         utils::status("[insert_vertices] Delaunay_check passed");
 #endif
 
-        for (int i = 1; i < vertex_count(); ++i)
-        {
-            m_vertices[i].Z = m_values[i - 1];
-        }
+        std::copy(m_values.begin() + 1, m_values.end(), m_vertices.Z.begin() + 1);
+
+        if (progress)
+            progress(1.f);
+        return true;
     }
 
     void TMesh::delaunay_check() const
     {
-        for (int i_face = 0; i_face < face_count(); ++i_face)
+        for (IndexType i_face = 0; i_face < face_count(); ++i_face)
         {
-            if (is_infinite_face(i_face))
+            if (is_free_face(i_face) || is_infinite_face(i_face))
                 continue;
             Face face = m_faces[i_face];
-            Point a = Vertex::as_point(m_vertices[face[0]]);
-            Point b = Vertex::as_point(m_vertices[face[1]]);
-            Point c = Vertex::as_point(m_vertices[face[2]]);
+            Point a = m_vertices.point(face[0]);
+            Point b = m_vertices.point(face[1]);
+            Point c = m_vertices.point(face[2]);
 
             for (auto n : face.Neighbors)
             {
                 if (is_infinite_face(n))
                     continue;
                 int i_edge = m_faces[n].get_edge(i_face);
-                Point p = Vertex::as_point(m_vertices[m_faces[n][i_edge]]);
-                assert(!in_circle(p, a, b, c));
+                Point p = m_vertices.point(m_faces[n][i_edge]);
+                assert(circle_side(p, a, b, c) <= 0);
             }
         }
     }
@@ -918,7 +2216,9 @@ namespace gam
         // Check the integrity of the vertices of the mesh.
         for (IndexType i = 0; i < vertex_count(); ++i)
         {
-            int i_face = m_vertices[i].FaceIndex;
+            if (is_free_vertex(i))
+                continue;
+            int i_face = m_vertices.FaceIndex[i];
             auto face = m_faces[i_face];
             assert(face[0] == i || face[1] == i || face[2] == i);
         }
@@ -926,6 +2226,8 @@ namespace gam
         // Check the integrity of each neighbor of each face of the mesh.
         for (IndexType i = 0; i < face_count(); ++i)
         {
+            if (is_free_face(i))
+                continue;
             auto face = m_faces[i];
             if (is_infinite_face(i))
             {
@@ -0,0 +1,122 @@
+#include "ThreadPool.h"
+
+namespace gam
+{
+    //! True on the threads that are running a chunk : a loop started from a chunk is not distributed again.
+    static thread_local bool s_in_task = false;
+
+    ThreadPool::ThreadPool(unsigned thread_count)
+    {
+        start(thread_count);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        stop();
+    }
+
+    ThreadPool &ThreadPool::instance()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::thread_count(unsigned count)
+    {
+        std::lock_guard call_lock(m_call_mutex);
+        stop();
+        start(count);
+    }
+
+    void ThreadPool::parallel_for(IndexType count, const std::function<void(IndexType, IndexType)> &task, IndexType grain)
+    {
+        if (count == 0)
+            return;
+
+        if (count < grain || s_in_task)
+        {
+            task(0, count);
+            return;
+        }
+
+        // The workers are read under the call mutex : thread_count(unsigned) may be restarting them.
+        std::unique_lock call_lock(m_call_mutex);
+        if (m_workers.empty())
+        {
+            call_lock.unlock();
+            task(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_chunk_count = thread_count();
+            m_pending = m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        // The calling thread runs the first chunk.
+        s_in_task = true;
+        task(0, count / m_chunk_count);
+        s_in_task = false;
+
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [this]()
+                    { return m_pending == 0; });
+        m_task = nullptr;
+    }
+
+    void ThreadPool::start(unsigned count)
+    {
+        if (count == 0)
+            count = std::max(1u, std::thread::hardware_concurrency());
+
+        m_stop = false;
+        for (unsigned i = 0; i + 1 < count; ++i)
+            m_workers.emplace_back(&ThreadPool::work, this, i, m_generation);
+    }
+
+    void ThreadPool::stop()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto &worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    void ThreadPool::work(unsigned i_worker, std::uint64_t generation)
+    {
+        while (true)
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&]()
+                        { return m_stop || m_generation != generation; });
+            if (m_stop)
+                return;
+            generation = m_generation;
+
+            const auto &task = *m_task;
+            std::uint64_t chunk = i_worker + 1;
+            IndexType begin = m_count * chunk / m_chunk_count;
+            IndexType end = m_count * (chunk + 1) / m_chunk_count;
+            lock.unlock();
+
+            s_in_task = true;
+            if (begin < end)
+                task(begin, end);
+            s_in_task = false;
+
+            lock.lock();
+            if (--m_pending == 0)
+                m_done.notify_one();
+        }
+    }
+} // namespace gam
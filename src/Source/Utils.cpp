@@ -1,30 +1,36 @@
 #include "Utils.h"
 
+#include "PointCloud.h"
+#include "ThreadPool.h"
+
 namespace utils
 {
-    std::vector<Point> read_point_set(const std::string &filename, float x_scale, float y_scale, float z_scale)
+    DataDirectories &data_directories()
     {
-        std::ifstream file(std::string(CLOUD_DIR) + filename);
-        if (!file.is_open())
-        {
-            error("[read_point_set] Couldn't open this file : ", std::string(CLOUD_DIR) + filename);
-            exit(1);
-        }
+        static DataDirectories directories;
+        return directories;
+    }
 
-        int num_points; 
-        file >> num_points; 
+    std::vector<Point> read_point_set(const std::string &filename, float x_scale, float y_scale, float z_scale)
+    {
+        std::optional<std::vector<Point>> points = gam::read_points(data_directories().Cloud + filename);
+        if (!points)
+            return {};
 
-        std::vector<Point> points;
-        points.reserve(num_points);
-        for (int i = 0; i < num_points; ++i)
+        if (x_scale != 1.f || y_scale != 1.f || z_scale != 1.f)
         {
-            float x, y, z; 
-            file >> x >> y >> z; 
-
-            points.emplace_back(x * x_scale, y * y_scale, z * z_scale); 
+            // Contiguous chunks of a branchless loop, vectorized by the compiler.
+            gam::parallel_for(points->size(), [&](gam::IndexType begin, gam::IndexType end)
+                              {
+                Point *data = points->data();
+                for (gam::IndexType i = begin; i < end; ++i)
+                {
+                    data[i].x *= x_scale;
+                    data[i].y *= y_scale;
+                    data[i].z *= z_scale;
+                } });
         }
-
-        return points;
+        return std::move(*points);
     }
 
 } // namespace utils
\ No newline at end of file
@@ -104,21 +104,26 @@ int Viewer::init_programs()
         return -1;
     }
 
+    m_program_normals = read_program(std::string(SHADER_DIR) + "/normals.glsl");
+    if (program_print_errors(m_program_normals) < 0)
+    {
+        utils::error("in [read_program] for", std::string(SHADER_DIR) + "/normals.glsl");
+        return -1;
+    }
+
     return 0;
 }
 
 int Viewer::init_laplacian_demo()
 {
     m_file_name = "cube";
-    m_laplacian.load_off("/" + m_file_name + ".off");
-    m_laplacian.vertex_value(0, 100);
-    m_laplacian.smooth_normals();
-    m_laplacian.curvature();
-    m_object = m_laplacian.mesh();
+    if (auto mesh = load_laplacian_mesh(m_file_name))
+        m_laplacian = std::move(*mesh);
+    m_object.update(m_laplacian);
 
     if (m_laplacian_demo)
     {
-        center_camera(m_object);
+        center_camera(m_object.bounds());
     }
 
     m_heat_diffusion_tex = read_texture(0, std::string(DATA_DIR) + "/gradient.png");
@@ -126,10 +131,111 @@ int Viewer::init_laplacian_demo()
     return 0;
 }
 
+std::optional<gam::TMesh> Viewer::load_laplacian_mesh(const std::string &file_name, const gam::ProgressCallback &progress)
+{
+    // The steps are not interruptible : progress is reported, and cancellation checked, between them.
+    auto step = [&progress](float value)
+    { return !progress || progress(value); };
+
+    std::filesystem::path off_path = utils::data_directories().Off + "/" + file_name + ".off";
+    std::filesystem::path tmesh_path = utils::data_directories().TMesh + "/" + file_name + ".tmesh";
+
+    std::error_code error;
+    auto off_time = std::filesystem::last_write_time(off_path, error);
+    bool cache_valid = std::filesystem::exists(tmesh_path) && (error || std::filesystem::last_write_time(tmesh_path, error) >= off_time);
+
+    gam::TMesh mesh;
+    if (cache_valid && mesh.load_tmesh("/" + file_name + ".tmesh"))
+    {
+        step(1.f);
+        return mesh;
+    }
+
+    if (!mesh.load_off("/" + file_name + ".off") || !step(0.5f))
+        return std::nullopt;
+
+    mesh.vertex_value(0, 100);
+    mesh.smooth_normals();
+    if (!step(0.6f))
+        return std::nullopt;
+
+    mesh.curvature();
+    if (!step(0.9f))
+        return std::nullopt;
+
+    mesh.save_tmesh("/" + file_name + ".tmesh");
+    step(1.f);
+    return mesh;
+}
+
+void Viewer::start_delaunay_load()
+{
+    m_delaunay_job.start([file_cloud = m_file_cloud, scale = m_scale, loading_percentage = m_loading_percentage, shuffle = m_shuffle,
+                          spatial_sort = m_spatial_sort, thread_count = m_thread_count, locate_strategy = m_locate_strategy,
+                          insertion_engine = m_insertion_engine](const gam::ProgressCallback &progress) -> std::optional<DelaunayLoad>
+                         {
+        DelaunayLoad load;
+        load.Points = utils::read_point_set("/" + file_cloud + ".txt", scale, scale, scale);
+        if (load.Points.size() < 3)
+            return std::nullopt;
+        load.PointCount = std::max(3, static_cast<int>(loading_percentage * 0.01f * load.Points.size()));
+
+        if (shuffle)
+        {
+            auto rd = std::random_device{};
+            auto rng = std::default_random_engine{rd()};
+            std::shuffle(std::begin(load.Points), std::end(load.Points), rng);
+        }
+
+        load.Mesh.locate_strategy(static_cast<gam::LocateStrategy>(locate_strategy));
+        load.Mesh.insertion_engine(static_cast<gam::InsertionEngine>(insertion_engine));
+
+        Timer timer;
+        timer.start();
+        bool complete = thread_count > 1 ? load.Mesh.insert_vertices_parallel(load.Points, load.PointCount, thread_count, progress)
+                                         : load.Mesh.insert_vertices(load.Points, load.PointCount, spatial_sort, progress);
+        timer.stop();
+        if (!complete)
+            return std::nullopt;
+
+        load.Ms = timer.ms();
+        load.Us = timer.us();
+        return load; });
+}
+
+void Viewer::poll_jobs()
+{
+    if (auto mesh = m_laplacian_job.take())
+    {
+        m_laplacian = std::move(*mesh);
+        m_object.update(m_laplacian);
+
+        center_camera(m_object.bounds());
+    }
+
+    if (auto load = m_delaunay_job.take())
+    {
+        m_points = std::move(load->Points);
+        m_point_count = load->PointCount;
+        m_delaunay = std::move(load->Mesh);
+
+        m_dttms = load->Ms;
+        m_dttus = load->Us;
+        m_object2.update(m_delaunay, true, !m_show_infinite_faces);
+
+        center_camera(m_object2.bounds());
+    }
+}
+
 int Viewer::init_delaunay_demo()
 {
     m_file_cloud = "blue_noise";
     m_points = utils::read_point_set("/blue_noise.txt");
+    if (m_points.size() < 400)
+    {
+        utils::error("in [init_delaunay_demo] The demo needs the 400 first points of blue_noise.txt");
+        return -1;
+    }
 
     auto rd = std::random_device{};
     auto rng = std::default_random_engine{rd()};
@@ -144,11 +250,11 @@ int Viewer::init_delaunay_demo()
     m_dttms = m_timer.ms();
     m_dttus = m_timer.us();
 
-    m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
+    m_object2.update(m_delaunay, true, !m_show_infinite_faces);
 
     if (m_delaunay_demo)
     {
-        center_camera(m_object2);
+        center_camera(m_object2.bounds());
     }
 
     return 0;
@@ -171,7 +277,7 @@ int Viewer::handle_events()
         {
             clear_key_state(SDLK_i);
             m_show_infinite_faces = !m_show_infinite_faces;
-            m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
+            m_object2.update(m_delaunay, true, !m_show_infinite_faces);
         }
 
         if (key_state(SDLK_e))
@@ -210,7 +316,7 @@ int Viewer::handle_events()
             if (m_show_heat_diffusion)
             {
                 m_laplacian.curvature();
-                m_object = m_laplacian.mesh(true);
+                m_object.update_values(m_laplacian, true);
                 m_show_heat_diffusion = false;
             }
             m_show_curvature = !m_show_curvature;
@@ -222,7 +328,7 @@ int Viewer::handle_events()
             if (m_show_curvature)
             {
                 m_laplacian.reset_values();
-                m_object = m_laplacian.mesh(false);
+                m_object.update_values(m_laplacian, false);
                 m_show_curvature = false;
             }
             m_show_heat_diffusion = !m_show_heat_diffusion;
@@ -258,7 +364,7 @@ int Viewer::handle_events()
             float time = -camera_position.z / direction.z;
             Point point = camera_position + time * direction;
             m_delaunay.insert_vertex(point);
-            m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
+            m_object2.update(m_delaunay, true, !m_show_infinite_faces);
         }
     }
 
@@ -267,6 +373,8 @@ int Viewer::handle_events()
 
 int Viewer::render()
 {
+    poll_jobs();
+
     if (render_ui() < 0)
     {
         utils::error("in [render_ui]");
@@ -298,6 +406,7 @@ int Viewer::quit_any()
     glDeleteTextures(1, &m_heat_diffusion_tex);
     release_program(m_program);
     release_program(m_program_edges);
+    release_program(m_program_normals);
     return 0;
 }
 
@@ -340,17 +449,20 @@ int Viewer::render_laplacian_demo()
 
     if (m_show_normals)
     {
-        DrawParam param;
-        param.model(model).view(view).projection(projection);
-        param.debug_normals(0.02 * m_camera.radius());
-        param.draw(m_object);
+        glUseProgram(m_program_normals);
+        program_uniform(m_program_normals, "mvpMatrix", mvp);
+        program_uniform(m_program_normals, "scale", 0.02f * m_camera.radius());
+        m_object.draw_triangles();
     }
     else if (m_show_heat_diffusion)
     {
-        m_laplacian.heat_diffusion(0.00001);
-        m_object = m_laplacian.mesh(false);
+        if (m_implicit_diffusion)
+            m_laplacian.heat_diffusion_implicit(m_diffusion_time_step);
+        else
+            m_laplacian.heat_diffusion(0.00001);
+        m_object.update_values(m_laplacian, false);
         program_use_texture(m_program, "uHeatDiffusionTex", 0, m_heat_diffusion_tex);
-        m_object.draw(m_program, true, true, true, false, false);
+        m_object.draw_triangles();
     }
     else if (m_show_faces)
     {
@@ -358,7 +470,7 @@ int Viewer::render_laplacian_demo()
         glPolygonOffset(1.0, 1.0);
         glDepthFunc(GL_LESS);
 
-        m_object.draw(m_program, true, true, true, false, false);
+        m_object.draw_triangles();
         glDisable(GL_POLYGON_OFFSET_FILL);
     }
 
@@ -371,9 +483,7 @@ int Viewer::render_laplacian_demo()
         GLint location = glGetUniformLocation(m_program_edges, "uEdgeColor");
         glUniform4fv(location, 1, &m_edges_color[0]);
 
-        m_object.bind_vao();
-
-        m_object.draw(m_program_edges, true, false, false, false, false);
+        m_object.draw_edges();
     }
 
     if (m_show_points)
@@ -385,9 +495,7 @@ int Viewer::render_laplacian_demo()
         GLint location = glGetUniformLocation(m_program_points, "uPointColor");
         glUniform4fv(location, 1, &m_points_color[0]);
 
-        m_object.bind_vao();
-
-        glDrawArrays(GL_POINTS, 0, m_object.vertex_count());
+        m_object.draw_points();
     }
 
     return 0;
@@ -422,7 +530,7 @@ int Viewer::render_delaunay_demo()
 
             GLuint location = glGetUniformLocation(m_program_2, "uMeshColor");
             glUniform4fv(location, 1, &m_mesh_color[0]);
-            m_object2.draw(m_program_2, true, false, false, true, false);
+            m_object2.draw_triangles();
             glDisable(GL_POLYGON_OFFSET_FILL);
         }
         if (m_show_edges)
@@ -434,7 +542,7 @@ int Viewer::render_delaunay_demo()
             GLint location = glGetUniformLocation(m_program_edges, "uEdgeColor");
             glUniform4fv(location, 1, &m_edges_color[0]);
 
-            m_object2.draw(m_program_edges, true, false, false, false, false);
+            m_object2.draw_edges();
         }
     }
 
@@ -447,9 +555,7 @@ int Viewer::render_delaunay_demo()
         GLint location = glGetUniformLocation(m_program_points, "uPointColor");
         glUniform4fv(location, 1, &m_points_color[0]);
 
-        m_object2.bind_vao();
-
-        glDrawArrays(GL_POINTS, 0, m_object2.vertex_count());
+        m_object2.draw_points();
     }
 
     return 0;
@@ -459,20 +565,22 @@ int Viewer::render_laplacian_params()
 {
     ImGui::SeparatorText("LOAD MESH");
     ImGui::InputTextWithHint("Off name", "ex : queen", &m_file_name);
-    if (ImGui::Button("Load mesh", ImVec2(-FLT_MIN, 35.0f)))
+    if (m_laplacian_job.running())
     {
-        m_laplacian.load_off("/" + m_file_name + ".off");
-        m_laplacian.vertex_value(0, 100);
-        m_laplacian.smooth_normals();
-        m_laplacian.curvature();
-        m_object = m_laplacian.mesh();
-
-        center_camera(m_object);
+        ImGui::ProgressBar(m_laplacian_job.progress(), ImVec2(-FLT_MIN, 0.0f), m_laplacian_job.cancelled() ? "Cancelling..." : nullptr);
+        if (ImGui::Button("Cancel", ImVec2(-FLT_MIN, 35.0f)))
+            m_laplacian_job.cancel();
+    }
+    else if (ImGui::Button("Load mesh", ImVec2(-FLT_MIN, 35.0f)))
+    {
+        m_laplacian_job.start([file_name = m_file_name](const gam::ProgressCallback &progress)
+                              { return load_laplacian_mesh(file_name, progress); });
     }
     ImGui::SeparatorText("SAVE MESH");
     ImGui::InputTextWithHint("filename", "my_mesh", &m_saved_file);
     ImGui::RadioButton("OBJ", &m_save_as_obj, 1); ImGui::SameLine();
-    ImGui::RadioButton("OFF", &m_save_as_obj, 0);
+    ImGui::RadioButton("OFF", &m_save_as_obj, 0); ImGui::SameLine();
+    ImGui::RadioButton("TMESH", &m_save_as_obj, 2);
     if (ImGui::Button("Save mesh", ImVec2(-FLT_MIN, 35.0f)))
     {
         if (m_saved_file.empty())
@@ -484,7 +592,11 @@ int Viewer::render_laplacian_params()
             int id = dis(gen);
             m_saved_file = m_file_name + std::to_string(id);
         }
-        if (m_save_as_obj)
+        if (m_save_as_obj == 2)
+        {
+            m_laplacian.save_tmesh("/" + m_saved_file + ".tmesh");
+        }
+        else if (m_save_as_obj)
         {
             m_laplacian.save_obj("/" + m_saved_file + ".obj");
         }
@@ -506,7 +618,7 @@ int Viewer::render_laplacian_params()
         if (m_show_heat_diffusion)
         {
             m_laplacian.curvature();
-            m_object = m_laplacian.mesh();
+            m_object.update_values(m_laplacian, true);
             m_show_heat_diffusion = false;
         }
     }
@@ -515,10 +627,19 @@ int Viewer::render_laplacian_params()
         if (m_show_curvature)
         {
             m_laplacian.reset_values();
-            m_object = m_laplacian.mesh(false);
+            m_object.update_values(m_laplacian, false);
             m_show_curvature = false;
         }
     }
+    int kernel_thread_count = gam::ThreadPool::instance().thread_count();
+    if (ImGui::SliderInt("Threads", &kernel_thread_count, 1, std::max(1u, std::thread::hardware_concurrency())))
+    {
+        gam::ThreadPool::instance().thread_count(kernel_thread_count);
+    }
+    ImGui::Checkbox("Implicit diffusion", &m_implicit_diffusion);
+    ImGui::BeginDisabled(!m_implicit_diffusion);
+    ImGui::SliderFloat("Time step", &m_diffusion_time_step, 0.00001f, 10.f, "%.5f", ImGuiSliderFlags_Logarithmic);
+    ImGui::EndDisabled();
 
     return 0;
 }
@@ -527,18 +648,24 @@ int Viewer::render_laplacian_stats()
 {
     ImGui::Text("#vertices : %i", m_object.vertex_count());
     ImGui::Text("#triangles : %i", m_object.triangle_count());
+    ImGui::Text("#edges : %i", m_object.edge_count());
+    ImGui::Text("Last GPU upload : %.1f KB", m_object.uploaded_bytes() / 1024.f);
+    if (m_implicit_diffusion)
+    {
+        ImGui::Text("CG iterations : %u", m_laplacian.solver_stats().Iterations);
+        ImGui::Text("CG residual : %.2e", m_laplacian.solver_stats().Residual);
+    }
 
     return 0;
 }
 
-void Viewer::set_infinite_z(Mesh &mesh, gam::TMesh& tmesh)
+void Viewer::set_infinite_z(GpuMesh &mesh, gam::TMesh& tmesh)
 {
-    Point pmin, pmax;
-    mesh.bounds(pmin, pmax);
+    auto [pmin, pmax] = mesh.bounds();
     Point mid = center(pmin, pmax);
     mid.z = -m_infinite_point_z;
     tmesh.vertex(0, mid);
-    mesh = tmesh.mesh(true, !m_show_infinite_faces);
+    mesh.update(tmesh, true, !m_show_infinite_faces);
 }
 
 int Viewer::render_delaunay_params()
@@ -550,12 +677,12 @@ int Viewer::render_delaunay_params()
     ImGui::SeparatorText("DELAUNAY PARAMS");
     if (ImGui::Button("Center camera", ImVec2(-FLT_MIN, 25.0f)))
     {
-        center_camera(m_object2);
+        center_camera(m_object2.bounds());
     }
 
     if (ImGui::Checkbox("Infinite faces (i)", &m_show_infinite_faces))
     {
-        m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
+        m_object2.update(m_delaunay, true, !m_show_infinite_faces);
     }
 
     if (ImGui::SliderFloat("Infinite point Z", &m_infinite_point_z, 0.01, 10000.0, "%.2f"))
@@ -563,32 +690,34 @@ int Viewer::render_delaunay_params()
         set_infinite_z(m_object2, m_delaunay);
     }
 
+    const char *strategies[] = {"First face", "Last inserted", "Jump and walk", "Hierarchy"};
+    if (ImGui::Combo("Point location", &m_locate_strategy, strategies, IM_ARRAYSIZE(strategies)))
+    {
+        m_delaunay.locate_strategy(static_cast<gam::LocateStrategy>(m_locate_strategy));
+    }
+
+    const char *engines[] = {"Lawson", "Bowyer-Watson"};
+    if (ImGui::Combo("Insertion", &m_insertion_engine, engines, IM_ARRAYSIZE(engines)))
+    {
+        m_delaunay.insertion_engine(static_cast<gam::InsertionEngine>(m_insertion_engine));
+    }
+
     ImGui::SeparatorText("LOAD FILE");
     ImGui::InputTextWithHint("Points cloud", "ex : alpes_random_2", &m_file_cloud);
     ImGui::InputFloat("Scale", &m_scale);
     ImGui::SliderInt("Loading percentage (%)", &m_loading_percentage, 0, 100);
     ImGui::Checkbox("Shuffle", &m_shuffle);
-    if (ImGui::Button("Load m_points cloud", ImVec2(-FLT_MIN, 35.0f)))
+    ImGui::Checkbox("Spatial sort (BRIO)", &m_spatial_sort);
+    ImGui::SliderInt("Threads", &m_thread_count, 1, std::max(1u, std::thread::hardware_concurrency()));
+    if (m_delaunay_job.running())
     {
-        m_points = utils::read_point_set("/" + m_file_cloud + ".txt", m_scale, m_scale, m_scale);
-        m_point_count = std::max(3, static_cast<int>(m_loading_percentage * 0.01f * m_points.size()));
-
-        if (m_shuffle)
-        {
-            auto rd = std::random_device{};
-            auto rng = std::default_random_engine{rd()};
-            std::shuffle(std::begin(m_points), std::end(m_points), rng);
-        }
-
-        m_timer.start();
-        m_delaunay.insert_vertices(m_points, m_point_count);
-        m_timer.stop();
-
-        m_dttms = m_timer.ms();
-        m_dttus = m_timer.us();
-        m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
-
-        center_camera(m_object2);
+        ImGui::ProgressBar(m_delaunay_job.progress(), ImVec2(-FLT_MIN, 0.0f), m_delaunay_job.cancelled() ? "Cancelling..." : nullptr);
+        if (ImGui::Button("Cancel", ImVec2(-FLT_MIN, 35.0f)))
+            m_delaunay_job.cancel();
+    }
+    else if (ImGui::Button("Load m_points cloud", ImVec2(-FLT_MIN, 35.0f)))
+    {
+        start_delaunay_load();
     }
 
     ImGui::SeparatorText("INSERTION");
@@ -614,14 +743,15 @@ int Viewer::render_delaunay_params()
         m_dttms += m_dttus / 1000;
         m_dttus = m_dttus % 1000;
 
-        m_object2 = m_delaunay.mesh(true, !m_show_infinite_faces);
+        m_object2.update(m_delaunay, true, !m_show_infinite_faces);
     }
     ImGui::EndDisabled();
 
     ImGui::SeparatorText("SAVE MESH");
     ImGui::InputTextWithHint("filename", "my_mesh", &m_saved_file);
     ImGui::RadioButton("OBJ", &m_save_as_obj, 1); ImGui::SameLine();
-    ImGui::RadioButton("OFF", &m_save_as_obj, 0);
+    ImGui::RadioButton("OFF", &m_save_as_obj, 0); ImGui::SameLine();
+    ImGui::RadioButton("TMESH", &m_save_as_obj, 2);
     if (ImGui::Button("Save mesh", ImVec2(-FLT_MIN, 35.0f)))
     {
         if (m_saved_file.empty())
@@ -634,7 +764,11 @@ int Viewer::render_delaunay_params()
             m_saved_file = m_file_cloud + std::to_string(id);
         }
 
-        if (m_save_as_obj)
+        if (m_save_as_obj == 2)
+        {
+            m_delaunay.save_tmesh("/" + m_saved_file + ".tmesh");
+        }
+        else if (m_save_as_obj)
         {
             m_delaunay.save_obj("/" + m_saved_file + ".obj", false, true);
         }
@@ -652,7 +786,23 @@ int Viewer::render_delaunay_stats()
 {
     ImGui::Text("#vertices : %i", m_object2.vertex_count());
     ImGui::Text("#triangles : %i", m_object2.triangle_count());
+    ImGui::Text("#edges : %i", m_object2.edge_count());
+    ImGui::Text("Last GPU upload : %.1f KB", m_object2.uploaded_bytes() / 1024.f);
     ImGui::Text("Triangulation time : %i ms %i us", m_dttms, m_dttus);
+    ImGui::Text("Average walk length : %.2f faces", m_delaunay.average_walk_length());
+    gam::PredicateStats predicates = gam::predicate_stats();
+    ImGui::Text("Exact orientation : %llu", static_cast<unsigned long long>(predicates.OrientationExact));
+    ImGui::Text("Exact in circle : %llu", static_cast<unsigned long long>(predicates.InCircleExact));
+#ifdef GAM_INSTRUMENTATION
+    gam::InstrumentationStats stats = gam::instrumentation_stats();
+    for (std::size_t i = 0; i < gam::COUNTER_COUNT; ++i)
+        ImGui::Text("%s : %llu", gam::counter_name(static_cast<gam::Counter>(i)), static_cast<unsigned long long>(stats.Values[i]));
+    if (ImGui::Button("Save trace"))
+        gam::write_chrome_trace(std::string(DATA_DIR) + "/trace.json");
+    ImGui::SameLine();
+    if (ImGui::Button("Reset counters"))
+        gam::reset_instrumentation_stats();
+#endif
 
     return 0;
 }
@@ -771,7 +921,7 @@ int Viewer::render_demo_buttons()
         m_laplacian_demo = true;
         m_delaunay_demo = false;
 
-        center_camera(m_object);
+        center_camera(m_object.bounds());
     }
     if (ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip))
     {
@@ -786,7 +936,7 @@ int Viewer::render_demo_buttons()
         m_laplacian_demo = false;
         m_delaunay_demo = true;
 
-        center_camera(m_object2);
+        center_camera(m_object2.bounds());
     }
     if (ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip))
     {
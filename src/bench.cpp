@@ -0,0 +1,680 @@
+#include "TMesh.h"
+#include "ThreadPool.h"
+
+#include <regex>
+
+//! Benchmarks of the TMesh operations, on the bundled datasets and on synthetic clouds. The results are written as JSON, in the format of Google Benchmark, so that two runs can be compared with its tools.
+
+namespace gam
+{
+    //! Access to the private steps of TMesh.
+    struct TMeshBenchmark
+    {
+        static std::pair<bool, std::pair<int, int>> locate_triangle(TMesh &mesh, const Point &p, std::uint64_t &steps)
+        {
+            return mesh.locate_triangle(p, mesh.start_face(p), steps);
+        }
+
+        //! Insert p without restoring the Delaunay property, returns the index of its vertex.
+        static IndexType split(TMesh &mesh, const Point &p)
+        {
+            auto [found, location] = locate_triangle(mesh, p, mesh.m_walk_steps);
+            if (!found)
+                return mesh.insert_outside(p, location.first);
+            if (location.second >= 0)
+                return mesh.edge_split(p, location.first, location.second);
+            return mesh.triangle_split(p, location.first);
+        }
+
+        static void lawson(TMesh &mesh, IndexType i_vertex) { mesh.lawson(i_vertex); }
+
+        //! Faces visited by the walks of the insertions and of the descents of the hierarchy since the last reset.
+        static std::uint64_t walk_steps(const TMesh &mesh) { return mesh.m_walk_steps; }
+
+        static void build_laplacian_operator(TMesh &mesh) { mesh.build_laplacian_operator(); }
+    };
+} // namespace gam
+
+namespace
+{
+    using gam::IndexType;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::regex Filter{".*"};
+        double MinTime{0.5};
+        IndexType MaxPoints{1000000};
+        std::string Output;
+    };
+
+    //! Iteration count of a run, and time excluded from the measure.
+    class State
+    {
+    public:
+        explicit State(std::uint64_t iterations) : m_iterations(iterations) {}
+
+        inline std::uint64_t iterations() const { return m_iterations; }
+
+        //! Stop the measure, for the setup of the next iteration.
+        void pause()
+        {
+            m_pause_real = Clock::now();
+            m_pause_cpu = std::clock();
+        }
+
+        void resume()
+        {
+            m_paused_real += std::chrono::duration<double>(Clock::now() - m_pause_real).count();
+            m_paused_cpu += static_cast<double>(std::clock() - m_pause_cpu) / CLOCKS_PER_SEC;
+        }
+
+        //! Set the number of items (points, faces, ...) processed by all the iterations.
+        inline void items_processed(std::uint64_t count) { m_items = count; }
+
+        //! Set a value reported along the timings (averages per iteration are computed by the benchmark).
+        inline void counter(const std::string &name, double value) { m_counters[name] = value; }
+
+    private:
+        friend class Runner;
+
+        std::uint64_t m_iterations;
+        std::uint64_t m_items{0};
+        std::map<std::string, double> m_counters;
+
+        Clock::time_point m_pause_real;
+        std::clock_t m_pause_cpu{0};
+        double m_paused_real{0.};
+        double m_paused_cpu{0.};
+    };
+
+    struct Result
+    {
+        std::string Name;
+        std::uint64_t Iterations;
+        //! Per iteration, in ns.
+        double RealTime;
+        double CpuTime;
+        double ItemsPerSecond;
+        std::map<std::string, double> Counters;
+    };
+
+    //! Run each benchmark enough times to measure it during at least MinTime seconds.
+    class Runner
+    {
+    public:
+        explicit Runner(const Options &options) : m_options(options) {}
+
+        inline bool matches(const std::string &name) const { return std::regex_search(name, m_options.Filter); }
+
+        void run(const std::string &name, const std::function<void(State &)> &benchmark)
+        {
+            if (!matches(name))
+                return;
+
+            std::uint64_t iterations = 1;
+            while (true)
+            {
+                State state(iterations);
+                auto real_start = Clock::now();
+                std::clock_t cpu_start = std::clock();
+                benchmark(state);
+                double real = std::chrono::duration<double>(Clock::now() - real_start).count() - state.m_paused_real;
+                double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC - state.m_paused_cpu;
+
+                if (real >= m_options.MinTime || iterations >= MAX_ITERATIONS)
+                {
+                    Result result{name, iterations, 1e9 * real / iterations, 1e9 * cpu / iterations,
+                                  real > 0. ? state.m_items / real : 0., state.m_counters};
+                    std::fprintf(stderr, "%-60s %14.0f ns %14.0f ns %10llu\n", name.c_str(), result.RealTime, result.CpuTime,
+                                 static_cast<unsigned long long>(iterations));
+                    m_results.push_back(std::move(result));
+                    return;
+                }
+
+                // Aim 40 % above the minimum time, growing at most 10 times per run.
+                double predicted = real > 0. ? 1.4 * m_options.MinTime / real * iterations : 10. * iterations;
+                iterations = std::clamp<std::uint64_t>(predicted, iterations + 1, std::min(10 * iterations, MAX_ITERATIONS));
+            }
+        }
+
+        void write(std::ostream &out, const char *executable) const
+        {
+            std::time_t now = std::time(nullptr);
+            char date[32];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            out << "{\n  \"context\": {\n";
+            out << "    \"date\": \"" << date << "\",\n";
+            out << "    \"executable\": \"" << executable << "\",\n";
+            out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+            out << "    \"pool_threads\": " << gam::ThreadPool::instance().thread_count() << ",\n";
+#ifdef NDEBUG
+            out << "    \"library_build_type\": \"release\"\n";
+#else
+            out << "    \"library_build_type\": \"debug\"\n";
+#endif
+            out << "  },\n  \"benchmarks\": [";
+            for (const auto &[i, result] : utils::enumerate(m_results))
+            {
+                out << (i == 0 ? "\n" : ",\n") << "    {\n";
+                out << "      \"name\": \"" << result.Name << "\",\n";
+                out << "      \"run_name\": \"" << result.Name << "\",\n";
+                out << "      \"run_type\": \"iteration\",\n";
+                out << "      \"iterations\": " << result.Iterations << ",\n";
+                out << "      \"real_time\": " << result.RealTime << ",\n";
+                out << "      \"cpu_time\": " << result.CpuTime << ",\n";
+                out << "      \"time_unit\": \"ns\"";
+                if (result.ItemsPerSecond > 0.)
+                    out << ",\n      \"items_per_second\": " << result.ItemsPerSecond;
+                for (const auto &[counter, value] : result.Counters)
+                    out << ",\n      \"" << counter << "\": " << value;
+                out << "\n    }";
+            }
+            out << "\n  ]\n}\n";
+        }
+
+        //! Add to the result of a benchmark its speedup (ratio of the items per second) over a baseline, if both were run.
+        void speedup(const std::string &name, const std::string &baseline, const std::string &counter)
+        {
+            auto find = [&](const std::string &n)
+            { return std::find_if(m_results.begin(), m_results.end(), [&](const Result &result)
+                                  { return result.Name == n; }); };
+            auto result = find(name);
+            auto reference = find(baseline);
+            if (result == m_results.end() || reference == m_results.end() || reference->ItemsPerSecond <= 0.)
+                return;
+            result->Counters[counter] = result->ItemsPerSecond / reference->ItemsPerSecond;
+            std::fprintf(stderr, "%-60s %13.2fx over %s\n", name.c_str(), result->Counters[counter], baseline.c_str());
+        }
+
+    private:
+        static constexpr std::uint64_t MAX_ITERATIONS = 1000000000;
+
+        Options m_options;
+        std::vector<Result> m_results;
+    };
+
+    /************************* Datasets **************************/
+
+    struct Cloud
+    {
+        std::string Name;
+        std::function<std::vector<Point>()> Generate;
+    };
+
+    //! Random clouds may draw the same float coordinates twice (likely from 10^6 points), the triangulation requires distinct points.
+    std::vector<Point> remove_duplicates(std::vector<Point> points, std::default_random_engine &rng)
+    {
+        auto less = [](const Point &a, const Point &b)
+        { return a.x < b.x || (a.x == b.x && a.y < b.y); };
+        auto equal = [](const Point &a, const Point &b)
+        { return a.x == b.x && a.y == b.y; };
+        std::sort(points.begin(), points.end(), less);
+        points.erase(std::unique(points.begin(), points.end(), equal), points.end());
+        std::shuffle(points.begin(), points.end(), rng);
+        return points;
+    }
+
+    std::vector<Point> uniform_cloud(IndexType n)
+    {
+        std::default_random_engine rng(n);
+        std::uniform_real_distribution<float> uniform(0.f, 1.f);
+        std::vector<Point> points(n);
+        for (auto &p : points)
+            p = Point(uniform(rng), uniform(rng), 0.f);
+        return remove_duplicates(std::move(points), rng);
+    }
+
+    //! Gaussian clusters around 32 random centers : the density varies by orders of magnitude.
+    std::vector<Point> clustered_cloud(IndexType n)
+    {
+        std::default_random_engine rng(n);
+        std::uniform_real_distribution<float> uniform(0.1f, 0.9f);
+        std::normal_distribution<float> normal(0.f, 0.02f);
+        std::array<Point, 32> centers;
+        for (auto &center : centers)
+            center = Point(uniform(rng), uniform(rng), 0.f);
+
+        std::vector<Point> points(n);
+        for (IndexType i = 0; i < n; ++i)
+            points[i] = Point(centers[i % centers.size()].x + normal(rng), centers[i % centers.size()].y + normal(rng), 0.f);
+        return remove_duplicates(std::move(points), rng);
+    }
+
+    //! Points of a regular grid, in random order : every empty circle goes through 4 points, and many points are inserted on an edge.
+    std::vector<Point> grid_cloud(IndexType n)
+    {
+        IndexType side = std::ceil(std::sqrt(static_cast<double>(n)));
+        std::vector<Point> points(n);
+        for (IndexType i = 0; i < n; ++i)
+            points[i] = Point(static_cast<float>(i % side), static_cast<float>(i / side), 0.f);
+
+        std::shuffle(points.begin(), points.end(), std::default_random_engine(n));
+        return points;
+    }
+
+    std::vector<std::string> data_files(const std::string &directory, const std::string &extension)
+    {
+        std::vector<std::string> names;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (entry.path().extension() == extension)
+                names.push_back(entry.path().stem().string());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    /************************* Benchmarks **************************/
+
+    //! Uniform random points in the bounding box of a cloud.
+    class PointSampler
+    {
+    public:
+        PointSampler(const std::vector<Point> &points) : m_rng(points.size())
+        {
+            float inf = std::numeric_limits<float>::infinity();
+            Point pmin(inf, inf, 0.f), pmax(-inf, -inf, 0.f);
+            for (const auto &p : points)
+            {
+                pmin = min(pmin, p);
+                pmax = max(pmax, p);
+            }
+            m_x = std::uniform_real_distribution<float>(pmin.x, pmax.x);
+            m_y = std::uniform_real_distribution<float>(pmin.y, pmax.y);
+        }
+
+        inline Point operator()() { return Point(m_x(m_rng), m_y(m_rng), 0.f); }
+
+    private:
+        std::default_random_engine m_rng;
+        std::uniform_real_distribution<float> m_x, m_y;
+    };
+
+    void triangulation_benchmarks(Runner &runner, const std::string &name, const std::vector<Point> &points)
+    {
+        runner.run("insert_vertices/" + name, [&](State &state)
+                   {
+            gam::TMesh mesh;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.insert_vertices(points, -1, true);
+            state.items_processed(state.iterations() * points.size()); });
+
+        runner.run("insert_vertices/bowyer_watson/" + name, [&](State &state)
+                   {
+            gam::TMesh mesh;
+            mesh.insertion_engine(gam::InsertionEngine::BowyerWatson);
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.insert_vertices(points, -1, true);
+            state.items_processed(state.iterations() * points.size()); });
+
+        std::vector<std::string> names;
+        for (const char *operation : {"locate_triangle/last_inserted/", "locate_triangle/jump_and_walk/", "insert_vertex/", "flip_edge/", "lawson/", "remove_vertex/", "move_vertex/", "move_vertices/",
+                                      "locate_triangle/hierarchy/", "insert_vertex/hierarchy/", "locate_points/"})
+            names.push_back(operation + name);
+        if (std::none_of(names.begin(), names.end(), [&](const std::string &n)
+                         { return runner.matches(n); }))
+            return;
+
+        // The operations are timed on the triangulation of the points, with queries drawn in their bounding box.
+        gam::TMesh base;
+        base.insert_vertices(points, -1, true);
+        PointSampler sample(points);
+        std::vector<Point> query_points(1 << 16);
+        std::generate(query_points.begin(), query_points.end(), std::ref(sample));
+        auto query = [&](std::uint64_t i) -> const Point &
+        { return query_points[i % query_points.size()]; };
+
+        for (auto strategy : {gam::LocateStrategy::LastInserted, gam::LocateStrategy::JumpAndWalk})
+        {
+            runner.run(names[strategy == gam::LocateStrategy::LastInserted ? 0 : 1], [&](State &state)
+                       {
+                base.locate_strategy(strategy);
+                std::uint64_t steps = 0;
+                for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                    gam::TMeshBenchmark::locate_triangle(base, query(i), steps);
+                state.items_processed(state.iterations());
+                state.counter("walk_steps", static_cast<double>(steps) / state.iterations()); });
+        }
+
+        // The walks in the levels of the hierarchy are counted apart from the walk in the mesh.
+        runner.run(names[8], [&](State &state)
+                   {
+            state.pause();
+            base.locate_strategy(gam::LocateStrategy::Hierarchy);
+            base.reset_walk_stats();
+            state.resume();
+            std::uint64_t steps = 0;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                gam::TMeshBenchmark::locate_triangle(base, query(i), steps);
+            state.items_processed(state.iterations());
+            state.counter("walk_steps", static_cast<double>(steps) / state.iterations());
+            state.counter("hierarchy_walk_steps", static_cast<double>(gam::TMeshBenchmark::walk_steps(base)) / state.iterations());
+            state.counter("hierarchy_levels", base.hierarchy_level_count());
+            state.counter("hierarchy_bytes_per_vertex", static_cast<double>(base.hierarchy_memory()) / base.vertex_count()); });
+        runner.speedup(names[8], names[0], "speedup_last_inserted");
+        runner.speedup(names[8], names[1], "speedup_jump_and_walk");
+        base.locate_strategy(gam::LocateStrategy::LastInserted);
+
+        // The same queries located at once, with their barycentric weights, and interpolated.
+        runner.run(names[10], [&](State &state)
+                   {
+            std::vector<gam::PointLocation> locations(query_points.size());
+            std::vector<gam::ScalarType> values(query_points.size());
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                base.locate_points(query_points, locations);
+                base.interpolate_values(locations, values);
+            }
+            state.items_processed(state.iterations() * query_points.size());
+            state.counter("threads", gam::ThreadPool::instance().thread_count()); });
+        runner.speedup(names[10], names[1], "speedup_jump_and_walk");
+
+        // The insertions grow a copy of the triangulation with new random points (reusing the queries would insert duplicates). Their walks start from a nearby vertex : the locate_triangle benchmarks time the walks alone.
+        std::default_random_engine rng(points.size());
+
+        runner.run(names[2], [&](State &state)
+                   {
+            state.pause();
+            gam::TMesh mesh = base;
+            mesh.locate_strategy(gam::LocateStrategy::JumpAndWalk);
+            state.resume();
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.insert_vertex(sample());
+            state.items_processed(state.iterations()); });
+
+        // Same insertions, the hierarchy being built on the copy and maintained by the insertions.
+        runner.run(names[9], [&](State &state)
+                   {
+            state.pause();
+            gam::TMesh mesh = base;
+            mesh.locate_strategy(gam::LocateStrategy::Hierarchy);
+            state.resume();
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.insert_vertex(sample());
+            state.items_processed(state.iterations());
+            state.counter("hierarchy_bytes_per_vertex", static_cast<double>(mesh.hierarchy_memory()) / mesh.vertex_count()); });
+        runner.speedup(names[9], names[2], "speedup_jump_and_walk");
+
+        // Convex interior edges whose quadrilaterals share no face : flip_edge is only valid on convex quadrilaterals, and each edge is flipped once on a copy of the triangulation.
+        std::vector<std::pair<IndexType, IndexType>> flippable;
+        std::vector<bool> used(base.face_count(), false);
+        const gam::VertexArray &vertices = base.vertices();
+        for (IndexType i_face = 0; i_face < base.face_count(); ++i_face)
+        {
+            for (IndexType i_edge = 0; i_edge < 3 && !used[i_face]; ++i_edge)
+            {
+                const gam::Face &face = base.faces()[i_face];
+                IndexType i_neighbor = face(i_edge);
+                if (used[i_neighbor] || base.is_infinite_face(i_face) || base.is_infinite_face(i_neighbor))
+                    continue;
+
+                const gam::Face &neighbor = base.faces()[i_neighbor];
+                Point a = vertices.point(face[i_edge]);
+                Point b = vertices.point(neighbor[neighbor.get_edge(i_face)]);
+                if (gam::orientation(a, b, vertices.point(face[(i_edge + 1) % 3])) * gam::orientation(a, b, vertices.point(face[(i_edge + 2) % 3])) < 0)
+                {
+                    flippable.emplace_back(i_face, i_edge);
+                    used[i_face] = used[i_neighbor] = true;
+                }
+            }
+        }
+
+        runner.run(names[3], [&](State &state)
+                   {
+            gam::TMesh mesh;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                if (i % flippable.size() == 0)
+                {
+                    state.pause();
+                    mesh = base;
+                    state.resume();
+                }
+                auto [i_face, i_edge] = flippable[i % flippable.size()];
+                mesh.flip_edge(i_face, i_edge);
+            }
+            state.items_processed(state.iterations()); });
+
+        runner.run(names[4], [&](State &state)
+                   {
+            state.pause();
+            gam::TMesh mesh = base;
+            mesh.locate_strategy(gam::LocateStrategy::JumpAndWalk);
+            state.resume();
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                state.pause();
+                IndexType i_vertex = gam::TMeshBenchmark::split(mesh, sample());
+                state.resume();
+                gam::TMeshBenchmark::lawson(mesh, i_vertex);
+            }
+            state.items_processed(state.iterations()); });
+
+        // The vertices are removed in random order from a copy of the triangulation, renewed when half of them are removed.
+        std::vector<IndexType> removals(base.vertex_count() - 1);
+        std::iota(removals.begin(), removals.end(), IndexType(1));
+        std::shuffle(removals.begin(), removals.end(), rng);
+        removals.resize(removals.size() / 2);
+
+        runner.run(names[5], [&](State &state)
+                   {
+            gam::TMesh mesh;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                if (i % removals.size() == 0)
+                {
+                    state.pause();
+                    mesh = base;
+                    state.resume();
+                }
+                mesh.remove_vertex(removals[i % removals.size()]);
+            }
+            state.items_processed(state.iterations()); });
+
+        // Distinct vertices jittered by a tenth of the mean spacing of the points, moved there and back again.
+        std::vector<IndexType> moved(base.vertex_count() - 1);
+        std::iota(moved.begin(), moved.end(), IndexType(1));
+        std::shuffle(moved.begin(), moved.end(), rng);
+        moved.resize(std::min<std::size_t>(moved.size(), 1 << 16));
+
+        float inf = std::numeric_limits<float>::infinity();
+        Point pmin(inf, inf, 0.f), pmax(-inf, -inf, 0.f);
+        for (const auto &p : points)
+        {
+            pmin = min(pmin, p);
+            pmax = max(pmax, p);
+        }
+        float jitter = 0.1f * std::sqrt((pmax.x - pmin.x) * (pmax.y - pmin.y) / points.size());
+        std::uniform_real_distribution<float> offset(-jitter, jitter);
+        std::vector<Point> origins, targets;
+        for (IndexType i_vertex : moved)
+        {
+            origins.push_back(vertices.point(i_vertex));
+            targets.push_back(origins.back() + Vector(offset(rng), offset(rng), 0.f));
+        }
+
+        runner.run(names[6], [&](State &state)
+                   {
+            state.pause();
+            gam::TMesh mesh = base;
+            state.resume();
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                std::size_t k = i % moved.size();
+                mesh.move_vertex(moved[k], (i / moved.size()) % 2 == 0 ? targets[k] : origins[k]);
+            }
+            state.items_processed(state.iterations()); });
+
+        runner.run(names[7], [&](State &state)
+                   {
+            state.pause();
+            gam::TMesh mesh = base;
+            state.resume();
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.move_vertices(moved, i % 2 == 0 ? targets : origins);
+            state.items_processed(state.iterations() * moved.size()); });
+    }
+
+    void mesh_benchmarks(Runner &runner, const std::string &name)
+    {
+        std::vector<std::string> names;
+        for (const char *operation : {"load_off/", "laplacian_operator/", "smooth_normals/", "heat_diffusion/", "heat_diffusion_implicit/"})
+            names.push_back(operation + name);
+        if (std::none_of(names.begin(), names.end(), [&](const std::string &n)
+                         { return runner.matches(n); }))
+            return;
+
+        gam::TMesh mesh;
+        runner.run(names[0], [&](State &state)
+                   {
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.load_off("/" + name + ".off");
+            state.items_processed(state.iterations() * mesh.face_count()); });
+
+        if (mesh.vertex_count() == 0 && !mesh.load_off("/" + name + ".off"))
+            return;
+        mesh.vertex_value(0, 100);
+
+        runner.run(names[1], [&](State &state)
+                   {
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                gam::TMeshBenchmark::build_laplacian_operator(mesh);
+            state.items_processed(state.iterations() * mesh.face_count()); });
+
+        runner.run(names[2], [&](State &state)
+                   {
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                mesh.smooth_normals();
+            state.items_processed(state.iterations() * mesh.vertex_count()); });
+
+        // One step per iteration, the operator is built before the measure. The heat source is reset every 64 steps, before the explicit scheme can diverge on fine meshes.
+        mesh.laplacian_operator();
+        auto reset = [&mesh](State &state, std::uint64_t i)
+        {
+            if (i % 64 != 0)
+                return;
+            state.pause();
+            mesh.reset_values();
+            mesh.vertex_value(0, 100);
+            state.resume();
+        };
+
+        runner.run(names[3], [&](State &state)
+                   {
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                reset(state, i);
+                mesh.heat_diffusion(0.00001f);
+            }
+            state.items_processed(state.iterations() * mesh.vertex_count()); });
+
+        runner.run(names[4], [&](State &state)
+                   {
+            IndexType cg_iterations = 0;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+            {
+                reset(state, i);
+                cg_iterations += mesh.heat_diffusion_implicit(0.001f).Iterations;
+            }
+            state.items_processed(state.iterations() * mesh.vertex_count());
+            state.counter("cg_iterations", static_cast<double>(cg_iterations) / state.iterations()); });
+    }
+
+    void usage()
+    {
+        utils::message("usage : gam_bench [options]\n",
+                       "  --benchmark_filter=<regex>    run the benchmarks whose name matches\n",
+                       "  --benchmark_min_time=<s>      minimum measured time of each benchmark (default 0.5)\n",
+                       "  --benchmark_out=<file>        write the JSON results to file (default : standard output)\n",
+                       "  --max_points=<n>              largest synthetic cloud, from 10^3 by powers of 10 (default 10^6, up to 10^7)");
+    }
+
+    bool parse(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            std::size_t equal = arg.find('=');
+            std::string_view key = arg.substr(0, equal);
+            std::string value(equal == std::string_view::npos ? "" : arg.substr(equal + 1));
+            if (key == "--benchmark_filter")
+                options.Filter = std::regex(value);
+            else if (key == "--benchmark_min_time")
+                options.MinTime = std::stod(value);
+            else if (key == "--benchmark_out")
+                options.Output = value;
+            else if (key == "--max_points")
+                options.MaxPoints = std::stoul(value);
+            else
+                return false;
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    // The library messages go to the error output, the standard output only receives the JSON results.
+    std::ostream json(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+#ifndef NDEBUG
+    utils::error("gam_bench is built without NDEBUG : the triangulations are checked and the timings are meaningless");
+#endif
+
+    Runner runner(options);
+
+    std::vector<Cloud> clouds;
+    for (const auto &name : data_files(utils::data_directories().Cloud, ".txt"))
+    {
+        runner.run("read_point_set/" + name, [&](State &state)
+                   {
+            std::size_t count = 0;
+            for (std::uint64_t i = 0; i < state.iterations(); ++i)
+                count += utils::read_point_set("/" + name + ".txt").size();
+            state.items_processed(count); });
+        clouds.push_back({name, [name]()
+                          { return utils::read_point_set("/" + name + ".txt"); }});
+    }
+    for (IndexType n = 1000; n <= options.MaxPoints; n *= 10)
+    {
+        clouds.push_back({"uniform/" + std::to_string(n), [n]()
+                          { return uniform_cloud(n); }});
+        clouds.push_back({"clustered/" + std::to_string(n), [n]()
+                          { return clustered_cloud(n); }});
+        clouds.push_back({"grid/" + std::to_string(n), [n]()
+                          { return grid_cloud(n); }});
+    }
+
+    for (const auto &cloud : clouds)
+    {
+        bool needed = false;
+        for (const char *operation : {"insert_vertices/", "insert_vertices/bowyer_watson/", "locate_triangle/last_inserted/", "locate_triangle/jump_and_walk/", "insert_vertex/", "flip_edge/", "lawson/", "remove_vertex/", "move_vertex/", "move_vertices/", "locate_triangle/hierarchy/", "insert_vertex/hierarchy/", "locate_points/"})
+            needed = needed || runner.matches(operation + cloud.Name);
+        if (needed)
+            triangulation_benchmarks(runner, cloud.Name, cloud.Generate());
+    }
+
+    for (const auto &name : data_files(utils::data_directories().Off, ".off"))
+        mesh_benchmarks(runner, name);
+
+    if (options.Output.empty())
+    {
+        runner.write(json, argv[0]);
+    }
+    else
+    {
+        std::ofstream file(options.Output);
+        runner.write(file, argv[0]);
+    }
+    return 0;
+}
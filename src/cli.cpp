@@ -0,0 +1,273 @@
+#include "TMesh.h"
+#include "Instrumentation.h"
+#include "PointCloud.h"
+#include "StreamingDelaunay.h"
+#include "ThreadPool.h"
+#include "Timer.h"
+
+//! Headless driver : triangulates the point clouds (.txt, .xyzf, .xyzd, .ply) and computes the normals, curvature and heat diffusion of the meshes (.off) given on the command line, several files at a time, and prints the duration of each stage.
+
+namespace
+{
+    struct Options
+    {
+        std::filesystem::path Output{OBJ_DIR};
+        unsigned JobCount{0};
+        bool SaveOff{false};
+        bool SpatialSort{true};
+        gam::InsertionEngine Engine{gam::InsertionEngine::Lawson};
+        bool Streaming{false};
+        gam::IndexType ChunkSize{gam::StreamingOptions().ChunkSize};
+        int DiffusionSteps{0};
+        float TimeStep{0.001f};
+        bool Implicit{false};
+        std::string Trace;
+        std::vector<std::filesystem::path> Inputs;
+    };
+
+    //! Duration of each stage of the processing of a file, in ms.
+    struct Report
+    {
+        std::filesystem::path File;
+        bool Success{false};
+        std::vector<std::pair<const char *, double>> Stages;
+    };
+
+    void usage()
+    {
+        utils::message("usage : gam_cli [options] <file or directory>...\n",
+                       "  Triangulates the point clouds (.txt, .xyzf, .xyzd, .ply) and computes the normals, curvature and heat diffusion of the meshes (.off).\n",
+                       "  -o <directory>     output directory (default ", OBJ_DIR, ")\n",
+                       "  -j <count>         number of files processed at a time (default : every core)\n",
+                       "  --off              save the results as .off files instead of .obj\n",
+                       "  --no-spatial-sort  insert the points in the order of the file\n",
+                       "  --bowyer-watson    insert the points by Bowyer-Watson cavities instead of Lawson flips\n",
+                       "  --streaming        triangulate the .txt point clouds out of core, by chunks (for clouds larger than the memory)\n",
+                       "  --chunk <count>    number of points per chunk of the streaming triangulation (default ", gam::StreamingOptions().ChunkSize, ")\n",
+                       "  --diffusion <n>    number of heat diffusion steps on the meshes (default 0)\n",
+                       "  --time-step <dt>   time step of the heat diffusion (default 0.001)\n",
+                       "  --implicit         implicit heat diffusion, stable for any time step\n",
+                       "  --trace <file>     write the timings as a Chrome trace (needs GAM_INSTRUMENTATION)");
+    }
+
+    bool parse(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string_view arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "-o" && has_value)
+                options.Output = argv[++i];
+            else if (arg == "-j" && has_value)
+                options.JobCount = std::stoul(argv[++i]);
+            else if (arg == "--off")
+                options.SaveOff = true;
+            else if (arg == "--no-spatial-sort")
+                options.SpatialSort = false;
+            else if (arg == "--bowyer-watson")
+                options.Engine = gam::InsertionEngine::BowyerWatson;
+            else if (arg == "--streaming")
+                options.Streaming = true;
+            else if (arg == "--chunk" && has_value)
+                options.ChunkSize = std::stoul(argv[++i]);
+            else if (arg == "--diffusion" && has_value)
+                options.DiffusionSteps = std::stoi(argv[++i]);
+            else if (arg == "--time-step" && has_value)
+                options.TimeStep = std::stof(argv[++i]);
+            else if (arg == "--implicit")
+                options.Implicit = true;
+            else if (arg == "--trace" && has_value)
+                options.Trace = argv[++i];
+            else if (arg.starts_with("-"))
+                return false;
+            else
+                options.Inputs.emplace_back(argv[i]);
+        }
+        return !options.Inputs.empty();
+    }
+
+    //! Get the point clouds and meshes among the inputs, the directories are searched (not recursively).
+    std::vector<std::filesystem::path> list_files(const std::vector<std::filesystem::path> &inputs)
+    {
+        auto supported = [](const std::filesystem::path &path)
+        { return gam::is_point_cloud(path) || path.extension() == ".off"; };
+
+        std::vector<std::filesystem::path> files;
+        for (const auto &input : inputs)
+        {
+            std::error_code error;
+            if (std::filesystem::is_directory(input, error))
+            {
+                std::vector<std::filesystem::path> entries;
+                for (const auto &entry : std::filesystem::directory_iterator(input, error))
+                {
+                    if (entry.is_regular_file() && supported(entry.path()))
+                        entries.push_back(std::filesystem::absolute(entry.path()));
+                }
+                std::sort(entries.begin(), entries.end());
+                files.insert(files.end(), entries.begin(), entries.end());
+            }
+            else if (std::filesystem::is_regular_file(input, error) && supported(input))
+                files.push_back(std::filesystem::absolute(input));
+            else
+                utils::error("in [gam_cli] Ignoring this input : ", input.string());
+        }
+        return files;
+    }
+
+    Report process(const std::filesystem::path &file, const Options &options)
+    {
+        Report report;
+        report.File = file;
+        Timer timer;
+        auto stage = [&](const char *name, auto &&function)
+        {
+            GAM_TRACE_SCOPE(name);
+            timer.start();
+            bool success = function();
+            timer.stop();
+            report.Stages.emplace_back(name, timer.ms() + timer.us() / 1000.);
+            return success;
+        };
+
+        std::filesystem::path output = options.Output / file.stem();
+        bool cloud = gam::is_point_cloud(file);
+        if (file.extension() == ".txt" && options.Streaming)
+        {
+            // The triangles are written while the cloud is read.
+            gam::StreamingOptions streaming;
+            streaming.ChunkSize = options.ChunkSize;
+            streaming.Engine = options.Engine;
+            report.Success = stage("streaming", [&]()
+                                   { return gam::triangulate_streaming(file.string(), output.string() + (options.SaveOff ? ".off" : ".obj"), streaming).has_value(); });
+            return report;
+        }
+
+        gam::TMesh mesh;
+        mesh.insertion_engine(options.Engine);
+        if (cloud)
+        {
+            std::vector<Point> points;
+            if (!stage("read", [&]()
+                       { points = utils::read_point_set(file.string());
+                         return points.size() >= 3; }))
+                return report;
+            stage("triangulate", [&]()
+                  { return mesh.insert_vertices(points, -1, options.SpatialSort); });
+        }
+        else
+        {
+            if (!stage("load", [&]()
+                       { return mesh.load_off(file.string()); }))
+                return report;
+            mesh.vertex_value(0, 100);
+            stage("normals", [&]()
+                  { mesh.smooth_normals();
+                    return true; });
+            stage("curvature", [&]()
+                  { mesh.curvature();
+                    return true; });
+            if (options.DiffusionSteps > 0)
+            {
+                stage("diffusion", [&]()
+                      {
+                    for (int i = 0; i < options.DiffusionSteps; ++i)
+                    {
+                        if (options.Implicit)
+                            mesh.heat_diffusion_implicit(options.TimeStep);
+                        else
+                            mesh.heat_diffusion(options.TimeStep);
+                    }
+                    return true; });
+            }
+        }
+
+        report.Success = stage("save", [&]()
+                               {
+            bool remove_infinite = cloud;
+            if (options.SaveOff)
+                mesh.save_off(output.string() + ".off", remove_infinite);
+            else
+                mesh.save_obj(output.string() + ".obj", false, remove_infinite);
+            return true; });
+        return report;
+    }
+
+    void print(const Report &report)
+    {
+        std::ostringstream line;
+        line << report.File.filename().string() << (report.Success ? "" : " FAILED");
+        double total = 0.;
+        for (auto [name, ms] : report.Stages)
+        {
+            line << "  " << name << " " << std::fixed << std::setprecision(3) << ms << " ms";
+            total += ms;
+        }
+        line << "  total " << std::fixed << std::setprecision(3) << total << " ms";
+        utils::message(line.str());
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parse(argc, argv, options))
+    {
+        usage();
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> files = list_files(options.Inputs);
+    std::error_code error;
+    std::filesystem::create_directories(options.Output, error);
+    options.Output = std::filesystem::absolute(options.Output);
+
+    // The paths given to the loaders and writers are complete.
+    utils::data_directories() = utils::DataDirectories{"", "", "", ""};
+
+    unsigned job_count = options.JobCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.JobCount;
+    job_count = std::min<unsigned>(job_count, std::max<std::size_t>(files.size(), 1));
+
+    // Files processed at the same time share the cores : the mesh kernels only use the pool when a single file is processed at a time.
+    if (job_count > 1)
+        gam::ThreadPool::instance().thread_count(1);
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<int> failures{0};
+    std::mutex print_mutex;
+    auto work = [&]()
+    {
+        for (std::size_t i = next++; i < files.size(); i = next++)
+        {
+            Report report = process(files[i], options);
+            if (!report.Success)
+                failures++;
+
+            std::lock_guard lock(print_mutex);
+            print(report);
+        }
+    };
+
+    Timer timer;
+    timer.start();
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < job_count; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto &thread : threads)
+        thread.join();
+    timer.stop();
+
+    utils::message(files.size(), " files processed in ", timer.ms(), " ms, ", failures.load(), " failed");
+
+#ifdef GAM_INSTRUMENTATION
+    gam::InstrumentationStats stats = gam::instrumentation_stats();
+    std::ostringstream counters;
+    for (std::size_t i = 0; i < gam::COUNTER_COUNT; ++i)
+        counters << (i == 0 ? "" : "  ") << gam::counter_name(static_cast<gam::Counter>(i)) << " " << stats.Values[i];
+    utils::message(counters.str());
+#endif
+    if (!options.Trace.empty() && !gam::write_chrome_trace(options.Trace))
+        return 1;
+    return failures == 0 ? 0 : 1;
+}